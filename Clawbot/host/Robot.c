@@ -0,0 +1,21 @@
+/** @file Robot.c
+ * @brief How this robot is put together, for the simulator ("make host"; see core/host)
+ *
+ * Only built for the PC. One motor drives each side, and the sonar faces forward; the
+ * simulated field has a wall 150 cm in front of where the robot starts, so autonomous has
+ * something to drive up to.
+ */
+
+#include "main.h"
+#include "Simulator.h"
+
+static const SimWheel WHEELS[] = {
+	{PORT_MOTOR_LEFT, PORT_ORIENTATION_1, SIM_LEFT, 0, 0, PORT_ORIENTATION_NORMAL, -1},
+	{PORT_MOTOR_RIGHT, PORT_ORIENTATION_10, SIM_RIGHT, 0, 0, PORT_ORIENTATION_NORMAL, -1}};
+
+const SimRobot simRobot = {
+	WHEELS, sizeof(WHEELS) / sizeof(WHEELS[0]),
+	31.9,   // 4 inch wheels
+	1060,   // about 30 cm between the wheels
+	0, 0,   // no gyro
+	ULTRASONIC_ORANGE, 150};
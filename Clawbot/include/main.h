@@ -29,13 +29,60 @@
 #define ULTRASONIC_YELLOW 3
 #define GREEN_LED_PIN 12
 
-#include <API.h>
+#define PORT_MOTOR_LEFT 1
+#define PORT_MOTOR_RIGHT 10
+#define PORT_MOTOR_CLAW 6
+#define PORT_MOTOR_ARM 7
+
+// which way round each motor port is wired (see K_setMotor() in the core library); the
+// right drive motor is reversed.
+#define PORT_ORIENTATION_1 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_2 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_3 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_4 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_5 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_6 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_7 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_8 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_9 PORT_ORIENTATION_NORMAL
+#define PORT_ORIENTATION_10 PORT_ORIENTATION_REVERSED
+
+// sonar filtering: keep the last SONAR_WINDOW readings, and trust the median only if at least
+// SONAR_MIN_GOOD of them were in range (1 - SONAR_MAX_RANGE cm). The sensor needs about
+// SONAR_SAMPLE_PERIOD ms between pings for old echoes to die away.
+#define SONAR_WINDOW 5
+#define SONAR_MIN_GOOD 3
+#define SONAR_MAX_RANGE 300
+#define SONAR_SAMPLE_PERIOD 50
+
+// every sensor the sensor registry (in the core library) reads for us, declared once
+// (K_SENSORS(), in init.c, hands it to the registry):
+//   X(name, SENSOR_TYPE_..., port, port2, how often to read it in ms)
+// Each one gets an id, SENSOR_<name>, for looking it up in a SensorSnapshot.
+#define SENSOR_LIST(X) \
+	X(SONAR,   SENSOR_TYPE_ULTRASONIC, ULTRASONIC_ORANGE, ULTRASONIC_YELLOW, SONAR_SAMPLE_PERIOD) \
+	X(BATTERY, SENSOR_TYPE_BATTERY,    0,                 0,                 1000)
+
+#include <kcore.h>
 #define BUTTON_PORT 3
 // Allow usage of this file in C++ programs
 #ifdef __cplusplus
 extern "C" {
 #endif
-Ultrasonic sonar;
+
+// SENSOR_SONAR, SENSOR_BATTERY: one for each entry in SENSOR_LIST, then SENSOR_COUNT.
+#define SENSOR_ID(name, type, port, port2, period) SENSOR_##name,
+enum { SENSOR_LIST(SENSOR_ID) SENSOR_COUNT };
+#undef SENSOR_ID
+
+/**
+ * one filtered sonar reading: distance in cm (0 if nothing is in range), and the millis() time
+ * it was taken.
+ */
+typedef struct {
+  int distance;
+  unsigned long timestamp;
+} SonarReading;
 
 // A function prototype looks exactly like its declaration, but with a semicolon instead of
 // actual code. If a function does not match a prototype, compile errors will occur.
@@ -103,6 +150,20 @@ void moveForward(int power, int timeInterval);
 void stopMotors();
 void stopall();
 
+// ---------------------------  Methods in SonarSampler.c
+/**
+ * starts filtering the sonar in the background. Call from initialize(), after
+ * sensorRegistryInit().
+ */
+void sonarSamplerInit();
+
+/**
+ * the latest filtered sonar distance in centimeters (0 if nothing is in range). If timestamp
+ * is not NULL, it is set to the millis() time the reading was taken. Never waits on the
+ * sensor.
+ */
+int sonarGetDistance(unsigned long *timestamp);
+
 // End C++ export structure
 #ifdef __cplusplus
 
@@ -0,0 +1,116 @@
+/** @file SonarSampler.c
+ * @brief Filters bad readings out of the ultrasonic sensor in the background
+ *
+ * The raw sonar is noisy, and every so often it reports 0 ("nothing there") or a wild
+ * distance even though something is right in front of it. The sensor registry (in the core
+ * library) reads it every SONAR_SAMPLE_PERIOD ms; this task picks up each new reading from
+ * the registry's snapshots, takes the median of the last few good readings, and leaves the
+ * answer where anybody can pick it up with sonarGetDistance() - without waiting for the
+ * sensor.
+ */
+
+#include "main.h"
+
+// the last SONAR_WINDOW raw readings, oldest first after "nextSample".
+static int window[SONAR_WINDOW];
+static int nextSample = 0;
+
+// the millis() time of the last raw reading put in the window.
+static unsigned long lastSampleTime;
+
+// the latest filtered reading, published by the task so a reader never has to wait for it.
+MAILBOX_DECLARE(SonarMailbox, SonarReading)
+static SonarMailbox readings;
+
+/**
+ * the median of the usable readings in the window, or 0 ("no object") if too few of them were
+ * usable to trust.
+ */
+static int filteredDistance()
+{
+	int good[SONAR_WINDOW];
+	int numGood = 0;
+
+	// throw out "nothing seen" and out-of-range readings, keeping the rest sorted
+	// (insertion sort - there are only a handful of them).
+	for (int i = 0; i < SONAR_WINDOW; i++)
+	{
+		int distance = window[i];
+		if (distance <= 0 || distance > SONAR_MAX_RANGE)
+			continue;
+		int j = numGood++;
+		while (j > 0 && good[j - 1] > distance)
+		{
+			good[j] = good[j - 1];
+			j--;
+		}
+		good[j] = distance;
+	}
+
+	// if most of the window is "nothing seen," there really is nothing there.
+	if (numGood < SONAR_MIN_GOOD)
+		return 0;
+	return good[numGood / 2];
+}
+
+/**
+ * adds one raw reading to the window, re-filters, and publishes the result.
+ */
+static void sampleSonar(const SensorValue *raw)
+{
+	lastSampleTime = raw->timestamp;
+	window[nextSample] = raw->value;
+	nextSample = (nextSample + 1) % SONAR_WINDOW;
+
+	SonarReading reading = {filteredDistance(), raw->timestamp};
+	SonarMailboxPublish(&readings, &reading);
+}
+
+/**
+ * the sonar task: looks at each snapshot the registry publishes, and filters in the raw
+ * reading whenever there is a new one.
+ */
+static void sonarTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	SensorSnapshot sensors;
+	while (true)
+	{
+		sensorSnapshotGet(&sensors);
+		if (sensors.reading[SENSOR_SONAR].timestamp != lastSampleTime)
+			sampleSonar(&sensors.reading[SENSOR_SONAR]);
+		taskDelayUntil(&wakeTime, SENSOR_TICK_PERIOD);
+	}
+}
+
+/**
+ * starts filtering the sonar in the background. Call from initialize(), after
+ * sensorRegistryInit().
+ */
+void sonarSamplerInit()
+{
+	// fill the window with the registry's first reading, so callers never see an empty filter.
+	SensorSnapshot sensors;
+	sensorSnapshotGet(&sensors);
+	for (int i = 0; i < SONAR_WINDOW; i++)
+		window[i] = sensors.reading[SENSOR_SONAR].value;
+	sampleSonar(&sensors.reading[SENSOR_SONAR]);
+
+	// a higher priority than the tasks that read it, so new readings are filtered promptly.
+	taskCreateMonitored("sonar", sonarTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_DEFAULT + 1);
+}
+
+/**
+ * the latest filtered sonar distance in centimeters (0 if nothing is in range). If timestamp
+ * is not NULL, it is set to the millis() time the reading was taken. Never waits on the
+ * sensor.
+ */
+int sonarGetDistance(unsigned long *timestamp)
+{
+	SonarReading copy;
+	SonarMailboxRead(&readings, &copy);
+	if (timestamp != NULL)
+		*timestamp = copy.timestamp;
+	return copy.distance;
+}
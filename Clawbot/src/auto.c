@@ -27,35 +27,35 @@
  */
  void moveForward(int power, int timeInterval)
  {
-   motorSet(1, power);
-   motorSet(10, -power);
+   K_setMotor(PORT_MOTOR_LEFT, power);
+   K_setMotor(PORT_MOTOR_RIGHT, power);
    delay(timeInterval);
  }
  void moveForwardUntil(int power)
  {
-   motorSet(1, power);
-   motorSet(10, -power);
-   while (ultrasonicGet(sonar) > 70)
+   K_setMotor(PORT_MOTOR_LEFT, power);
+   K_setMotor(PORT_MOTOR_RIGHT, power);
+   while (sonarGetDistance(NULL) > 70)
    {
-     delay(100);
+     delay(SONAR_SAMPLE_PERIOD); // no point checking more often than the sonar updates.
      if (!isAutonomous())
       break;
    }
-     motorSet(1, 0);
-     motorSet(10, 0);
+     K_stopMotor(PORT_MOTOR_LEFT);
+     K_stopMotor(PORT_MOTOR_RIGHT);
 
  }
  void stopall()
  {
-   motorSet(1, 0);
-   motorSet(10, 0);
-   motorSet(6, 0);
-   motorSet(7, 0);
+   K_stopMotor(PORT_MOTOR_LEFT);
+   K_stopMotor(PORT_MOTOR_RIGHT);
+   K_stopMotor(PORT_MOTOR_CLAW);
+   K_stopMotor(PORT_MOTOR_ARM);
  }
  void stopMotors()
  {
-   motorSet(1, 0);
-   motorSet(10, 0);
+   K_stopMotor(PORT_MOTOR_LEFT);
+   K_stopMotor(PORT_MOTOR_RIGHT);
  }
 
 void autonomous()
@@ -75,5 +75,5 @@ void autonomous()
   moveForwardUntil(127);
 }
 
-// printf("Distance is: %d\n",ultrasonicGet(sonar));
+// printf("Distance is: %d\n",sonarGetDistance(NULL));
 // delay(200);
@@ -12,6 +12,12 @@
 
 #include "main.h"
 
+// which way each motor port turns, for K_setMotor() (from PORT_ORIENTATION_n in main.h).
+K_MOTOR_DIRECTIONS;
+
+// every sensor the sensor registry reads (SENSOR_LIST in main.h).
+K_SENSORS(SENSOR_LIST);
+
 /*
  * Runs pre-initialization code. This function will be started in kernel mode one time while the
  * VEX Cortex is starting up. As the scheduler is still paused, most API functions will fail.
@@ -39,5 +45,11 @@ void initializeIO() {
  * can be implemented in this task if desired.
  */
 void initialize() {
-  sonar = ultrasonicInit(ULTRASONIC_ORANGE, ULTRASONIC_YELLOW);
+  // the sensor registry's task is watched, timed and kept to its deadline by these.
+  stackMonitorInit();
+  profilerInit();
+  deadlineInit();
+
+  sensorRegistryInit(NULL);
+  sonarSamplerInit();
 }
@@ -74,16 +74,16 @@ void operatorControl()
 						armPower = armPower  -110;
 					}
 
-					motorSet(6,clawPower);
-					motorSet(7,armPower);
+					K_setMotor(PORT_MOTOR_CLAW, clawPower);
+					K_setMotor(PORT_MOTOR_ARM, armPower);
 
-					motorSet(1, power + turn);
-					motorSet(10, -1*(power-turn)); // the -1 is because the motor is reversed.
+					K_setMotor(PORT_MOTOR_LEFT, power + turn);
+					K_setMotor(PORT_MOTOR_RIGHT, power - turn); // (the motor is reversed; see main.h)
 
 					// printf ("Test.");
 					// printf("%d",digitalRead(BUTTON_PORT));
 
-					if (ultrasonicGet(sonar) > 70)
+					if (sonarGetDistance(NULL) > 70)
 					{
 						digitalWrite(GREEN_LED_PIN, HIGH);
 					}
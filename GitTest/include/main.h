@@ -25,7 +25,7 @@
 // This prevents multiple inclusion, which isn't bad for this file but is good practice
 #define MAIN_H_
 
-#include <API.h>
+#include <kcore.h>
 
 // Allow usage of this file in C++ programs
 #ifdef __cplusplus
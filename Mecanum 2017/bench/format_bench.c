@@ -0,0 +1,96 @@
+/** @file format_bench.c
+ * @brief Times K_format() (Format.h) against snprintf() on a PC
+ *
+ * Formats the same LCD lines the robot shows, both ways, checks that the text matches, and
+ * prints how long each takes. snprintf() here is the PC's C library rather than the PROS
+ * one, but both read through the format string the same way, so the ratio is a fair guide.
+ * From the project folder, "make host" builds it as bin/host/format_bench; or by hand:
+ *
+ *   cc -O2 -std=gnu99 -I../core/include bench/format_bench.c -o format_bench && ./format_bench
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Format.h"
+
+#define ROUNDS 2000000
+#define LINE 32
+
+// read through volatiles, so the compiler can't work the answers out ahead of time.
+static volatile int heading = -137;
+static volatile int idle = 723;
+static volatile unsigned long latencyMin = 412, latencyMean = 1893, latencyP99 = 20144;
+static volatile const char *sectionName = "odometry";
+
+static double seconds()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int lineWithPrintf(char *line, int which)
+{
+	switch (which)
+	{
+	case 0:
+		return snprintf(line, LINE, "Field %4d deg", heading);
+	case 1:
+		return snprintf(line, LINE, "CPU idle %3d.%d%%", idle / 10, idle % 10);
+	case 2:
+		return snprintf(line, LINE, "%-8s %3d.%d%%", sectionName, idle / 10, idle % 10);
+	default:
+		return snprintf(line, LINE, "%lu/%lu/%lu us", latencyMin, latencyMean, latencyP99);
+	}
+}
+
+static int lineWithFormat(char *line, int which)
+{
+	switch (which)
+	{
+	case 0:
+		return K_format(line, LINE, K_STR("Field "), K_INT(heading, 4), K_STR(" deg"));
+	case 1:
+		return K_format(line, LINE, K_STR("CPU idle "), K_FIXED(idle, 1, 5), K_CHAR('%'));
+	case 2:
+		return K_format(line, LINE, K_STR_PAD((const char *)sectionName, 8), K_CHAR(' '),
+		                K_FIXED(idle, 1, 5), K_CHAR('%'));
+	default:
+		return K_format(line, LINE, K_UINT(latencyMin, 0), K_CHAR('/'), K_UINT(latencyMean, 0),
+		                K_CHAR('/'), K_UINT(latencyP99, 0), K_STR(" us"));
+	}
+}
+
+int main()
+{
+	char expected[LINE];
+	char line[LINE];
+	int failures = 0;
+
+	for (int which = 0; which < 4; which++)
+	{
+		lineWithPrintf(expected, which);
+		lineWithFormat(line, which);
+		if (strcmp(expected, line) != 0)
+		{
+			printf("MISMATCH: snprintf '%s', K_format '%s'\n", expected, line);
+			failures++;
+		}
+	}
+
+	double start = seconds();
+	for (int i = 0; i < ROUNDS; i++)
+		lineWithPrintf(line, i & 3);
+	double printfTime = seconds() - start;
+
+	start = seconds();
+	for (int i = 0; i < ROUNDS; i++)
+		lineWithFormat(line, i & 3);
+	double formatTime = seconds() - start;
+
+	printf("snprintf: %6.1f ns per line\n", printfTime / ROUNDS * 1e9);
+	printf("K_format: %6.1f ns per line (%.1fx faster)\n", formatTime / ROUNDS * 1e9,
+	       printfTime / formatTime);
+	return failures;
+}
@@ -0,0 +1,27 @@
+/** @file Robot.c
+ * @brief How this robot is put together, for the simulator ("make host"; see core/host)
+ *
+ * Only built for the PC. The four mecanum wheels each have a quadrature encoder, and the
+ * gyro is on PORT_GYRO; the port numbers and orientations all come from main.h, so this only
+ * needs changing if a wheel gains or loses a sensor.
+ */
+
+#include "main.h"
+#include "Simulator.h"
+
+static const SimWheel WHEELS[] = {
+	{PORT_MOTOR_FRONT_LEFT, PORT_ORIENTATION_9, SIM_LEFT, PORT_QUAD_FRONT_LEFT_A,
+	 PORT_QUAD_FRONT_LEFT_B, QUAD_ORIENTATION_FRONT_LEFT, -1},
+	{PORT_MOTOR_BACK_LEFT, PORT_ORIENTATION_8, SIM_LEFT, PORT_QUAD_BACK_LEFT_A,
+	 PORT_QUAD_BACK_LEFT_B, QUAD_ORIENTATION_BACK_LEFT, -1},
+	{PORT_MOTOR_FRONT_RIGHT, PORT_ORIENTATION_7, SIM_RIGHT, PORT_QUAD_FRONT_RIGHT_A,
+	 PORT_QUAD_FRONT_RIGHT_B, QUAD_ORIENTATION_FRONT_RIGHT, -1},
+	{PORT_MOTOR_BACK_RIGHT, PORT_ORIENTATION_6, SIM_RIGHT, PORT_QUAD_BACK_RIGHT_A,
+	 PORT_QUAD_BACK_RIGHT_B, QUAD_ORIENTATION_BACK_RIGHT, -1}};
+
+const SimRobot simRobot = {
+	WHEELS, sizeof(WHEELS) / sizeof(WHEELS[0]),
+	31.9, // 4 inch wheels
+	ODOMETRY_TICKS_PER_TURN,
+	PORT_GYRO, (double)GYRO_MULTIPLIER_DIVISOR / GYRO_DEFAULT_MULTIPLIER * GYRO_ORIENTATION,
+	0, 0};
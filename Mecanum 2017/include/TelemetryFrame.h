@@ -0,0 +1,57 @@
+/** @file TelemetryFrame.h
+ * @brief The layout of one telemetry frame, shared by the robot and tools/telemetry.py
+ *
+ * Each frame is the fields below, in this order, packed with no padding, little-endian (as
+ * the Cortex stores them), followed by a crc16() of those bytes. On the wire the whole thing
+ * is COBS-encoded (so it contains no zero bytes) and ends with a single zero byte.
+ *
+ * The core library's telemetry (Telemetry.c) sends frames of this type, named by
+ * K_TELEMETRY() in init.c; telemetrySample() (RobotTelemetry.c) fills them in.
+ * tools/telemetry.py reads TELEMETRY_FIELDS straight out of this file, so to send something
+ * new, add a line here (and fill it in, in telemetrySample()) and bump TELEMETRY_VERSION.
+ * Keep to the fixed-size types below; the tool knows their sizes.
+ */
+
+#ifndef TELEMETRY_FRAME_H_
+#define TELEMETRY_FRAME_H_
+
+#include <stdint.h>
+
+// goes up by one whenever TELEMETRY_FIELDS changes, so old recordings aren't misread.
+#define TELEMETRY_VERSION 1
+
+// bits in the "flags" field
+#define TELEMETRY_FLAG_FIELD_CENTRIC 0x01 // field-centric driving was on
+#define TELEMETRY_FLAG_AUTONOMOUS 0x02    // sent from the autonomous loop
+#define TELEMETRY_FLAG_DROPPED 0x04       // frames were lost just before this one (or the
+                                          // robot was degraded, and sent none)
+
+// X(type, name, what it is) for each field of a frame.
+#define TELEMETRY_FIELDS(X) \
+	X(uint8_t,  version,           "TELEMETRY_VERSION")                                     \
+	X(uint8_t,  flags,             "TELEMETRY_FLAG_... bits")                               \
+	X(uint16_t, sequence,          "goes up by one each frame, so gaps show lost frames")   \
+	X(uint32_t, time_us,           "micros() when the frame was filled in")                 \
+	X(uint16_t, cycle_us,          "time since the previous frame")                         \
+	X(uint16_t, battery_mv,        "main battery")                                          \
+	X(int32_t,  heading_mdeg,      "fused heading, counter-clockwise")                      \
+	X(int32_t,  turn_rate_mdps,    "gyro turn rate, mdeg/s")                                \
+	X(int16_t,  speed_front_left,  "wheel encoder speed, ticks/s")                          \
+	X(int16_t,  speed_back_left,   "wheel encoder speed, ticks/s")                          \
+	X(int16_t,  speed_front_right, "wheel encoder speed, ticks/s")                          \
+	X(int16_t,  speed_back_right,  "wheel encoder speed, ticks/s")                          \
+	X(int8_t,   joy_x,             "drift wanted, -127 to 127")                             \
+	X(int8_t,   joy_y,             "drive wanted, -127 to 127")                             \
+	X(int8_t,   joy_turn,          "twist wanted, -127 to 127")                             \
+	X(int8_t,   motor_front_left,  "power sent to the motor (K_getMotor())")                \
+	X(int8_t,   motor_back_left,   "power sent to the motor (K_getMotor())")                \
+	X(int8_t,   motor_front_right, "power sent to the motor (K_getMotor())")                \
+	X(int8_t,   motor_back_right,  "power sent to the motor (K_getMotor())")
+
+#define TELEMETRY_FIELD(type, name, description) type name;
+typedef struct __attribute__((packed)) {
+	TELEMETRY_FIELDS(TELEMETRY_FIELD)
+} TelemetryFrame;
+#undef TELEMETRY_FIELD
+
+#endif
@@ -29,9 +29,8 @@
 #define PORT_MOTOR_FRONT_LEFT 9
 #define PORT_MOTOR_FRONT_RIGHT 7
 
-#define PORT_ORIENTATION_NORMAL 1
-#define PORT_ORIENTATION_REVERSED -1
-
+// which way round each motor port is wired (PORT_ORIENTATION_NORMAL or _REVERSED, from
+// kcore.h), so K_setMotor() can take positive as forward on every port.
 #define PORT_ORIENTATION_1 PORT_ORIENTATION_REVERSED
 #define PORT_ORIENTATION_2 PORT_ORIENTATION_NORMAL
 #define PORT_ORIENTATION_3 PORT_ORIENTATION_REVERSED
@@ -43,13 +42,297 @@
 #define PORT_ORIENTATION_9 PORT_ORIENTATION_NORMAL
 #define PORT_ORIENTATION_10 PORT_ORIENTATION_NORMAL
 
+// the gyro is on an analog port. If the robot reads its heading backwards (turning left
+// makes the number go down), change GYRO_ORIENTATION to PORT_ORIENTATION_REVERSED.
+#define PORT_GYRO 1
+#define GYRO_ORIENTATION PORT_ORIENTATION_NORMAL
+
+// analog sampling (AnalogSampler.c): every ANALOG_SAMPLE_PERIOD ms each port is read
+// ANALOG_OVERSAMPLE times; every ANALOG_DECIMATION periods the 16 readings are added into one
+// 16-bit value and smoothed. Each port's smoothing is set by ANALOG_FILTER_SHIFT_n: 0 means
+// none, and each step up halves how quickly the value follows changes.
+#define ANALOG_SAMPLE_PERIOD 1
+#define ANALOG_OVERSAMPLE 4
+#define ANALOG_DECIMATION 4
+
+#define ANALOG_FILTER_SHIFT_1 0 // the gyro does its own filtering
+#define ANALOG_FILTER_SHIFT_2 2
+#define ANALOG_FILTER_SHIFT_3 2
+#define ANALOG_FILTER_SHIFT_4 2
+#define ANALOG_FILTER_SHIFT_5 2
+#define ANALOG_FILTER_SHIFT_6 2
+#define ANALOG_FILTER_SHIFT_7 2
+#define ANALOG_FILTER_SHIFT_8 2
+
+// gyro integration (GyroHeading.c). The gyro is read each time the analog sampler has a new
+// value for it. One ADC count is worth about (multiplier / GYRO_MULTIPLIER_DIVISOR) degrees
+// per second; the multiplier starts at GYRO_DEFAULT_MULTIPLIER, the same default gyroInit()
+// uses.
+#define GYRO_SAMPLE_PERIOD (ANALOG_SAMPLE_PERIOD * ANALOG_DECIMATION)
+#define GYRO_DEFAULT_MULTIPLIER 196
+#define GYRO_MULTIPLIER_DIVISOR 176
+
+// where the gyro calibration is saved. Change the version whenever GyroCalibration changes,
+// so an old file is not misread.
+#define GYRO_CALIBRATION_FILE "gyrocal"
+#define GYRO_CALIBRATION_VERSION 1
+#define GYRO_CALIBRATION_SAMPLES 256
+
+// drift tracking: the robot counts as still after GYRO_STILL_SAMPLES readings in a row within
+// GYRO_STILL_BAND (sixteenths of a count) of the bias, with the drive motors off. The bias
+// then moves 1/GYRO_DRIFT_GAIN of the way to the average of those readings.
+#define GYRO_STILL_BAND 48
+#define GYRO_STILL_SAMPLES 250
+#define GYRO_DRIFT_GAIN 8
+
+// IMEs: the whole chain is read every IME_SAMPLE_PERIOD ms. Only the first IME_CACHE_MAX are
+// used; API.h warns that more than 10 on one chain is unreliable.
+#define IME_SAMPLE_PERIOD 20
+#define IME_CACHE_MAX 10
+
+// the kinds of sensor only this robot has, read by readRobotSensor() in RobotSensors.c (the
+// sensor registry in the core library reads the rest - SENSOR_TYPE_BATTERY and so on).
+#define SENSOR_TYPE_GYRO_HEADING (SENSOR_TYPE_ROBOT + 0)   // millidegrees, from GyroHeading.c
+#define SENSOR_TYPE_GYRO_RATE (SENSOR_TYPE_ROBOT + 1)      // millidegrees per second
+#define SENSOR_TYPE_QUAD_ENCODER (SENSOR_TYPE_ROBOT + 2)   // ticks; port is QUAD_FRONT_LEFT etc.
+#define SENSOR_TYPE_QUAD_VELOCITY (SENSOR_TYPE_ROBOT + 3)  // ticks per second; port as above
+#define SENSOR_TYPE_IME (SENSOR_TYPE_ROBOT + 4)            // counts; port is the IME address
+#define SENSOR_TYPE_IME_VELOCITY (SENSOR_TYPE_ROBOT + 5)   // as imeGetVelocity()
+#define SENSOR_TYPE_ANALOG_SAMPLED (SENSOR_TYPE_ROBOT + 6) // 0-65535, from the analog sampler
+
+// every sensor on the robot, declared once (K_SENSORS(), in init.c, hands it to the registry):
+//   X(name, SENSOR_TYPE_..., port, port2, how often to read it in ms)
+// Each one gets an id, SENSOR_<name>, for looking it up in a SensorSnapshot.
+#define SENSOR_LIST(X) \
+	X(HEADING,              SENSOR_TYPE_GYRO_HEADING,  0,                0, 5)    \
+	X(TURN_RATE,            SENSOR_TYPE_GYRO_RATE,     0,                0, 5)    \
+	X(FRONT_LEFT_TICKS,     SENSOR_TYPE_QUAD_ENCODER,  QUAD_FRONT_LEFT,  0, 5)    \
+	X(BACK_LEFT_TICKS,      SENSOR_TYPE_QUAD_ENCODER,  QUAD_BACK_LEFT,   0, 5)    \
+	X(FRONT_RIGHT_TICKS,    SENSOR_TYPE_QUAD_ENCODER,  QUAD_FRONT_RIGHT, 0, 5)    \
+	X(BACK_RIGHT_TICKS,     SENSOR_TYPE_QUAD_ENCODER,  QUAD_BACK_RIGHT,  0, 5)    \
+	X(FRONT_LEFT_SPEED,     SENSOR_TYPE_QUAD_VELOCITY, QUAD_FRONT_LEFT,  0, 10)   \
+	X(BACK_LEFT_SPEED,      SENSOR_TYPE_QUAD_VELOCITY, QUAD_BACK_LEFT,   0, 10)   \
+	X(FRONT_RIGHT_SPEED,    SENSOR_TYPE_QUAD_VELOCITY, QUAD_FRONT_RIGHT, 0, 10)   \
+	X(BACK_RIGHT_SPEED,     SENSOR_TYPE_QUAD_VELOCITY, QUAD_BACK_RIGHT,  0, 10)   \
+	X(BATTERY,              SENSOR_TYPE_BATTERY,       0,                0, 1000)
+
+// numbers that can be changed over the console while the robot runs (Parameters.c):
+//   X(name, PARAM_TYPE_..., default, smallest, largest)
+// Each one gets an id, PARAM_<name>; read it with paramGet(PARAM_<name>).
+// They are saved (by "param save") in PARAMETER_FILE; change the version whenever
+// SavedParameters changes.
+#define PARAMETER_FILE "params"
+#define PARAMETER_FILE_VERSION 1
+#define PARAM_TYPE_INT 0
+#define PARAM_TYPE_MS 1 // a time, in ms
+#define PARAMETER_LIST(X) \
+	X(DEADBAND,             PARAM_TYPE_INT, 10,   0, 60)      \
+	X(AUTO_AHEAD_TIME,      PARAM_TYPE_MS,  0,    0, 15000)   \
+	X(AUTO_STOP_TIME,       PARAM_TYPE_MS,  500,  0, 15000)   \
+	X(AUTO_BLINK_TIME,      PARAM_TYPE_MS,  250,  0, 15000)   \
+	X(AUTO_BLINK_PERIOD,    PARAM_TYPE_MS,  500,  20, 5000)   \
+	X(AUTO_REVERSE_TIME,    PARAM_TYPE_MS,  1000, 0, 15000)   \
+	X(AUTO_EXTRA_BLINK_TIME, PARAM_TYPE_MS, 1500, 0, 15000)   \
+	X(AUTO_BLINK_END_TIME,  PARAM_TYPE_MS,  1250, 0, 15000)
+
+// the odometry loop (Odometry.c) runs every ODOMETRY_PERIOD ms, and each update should take
+// no more than ODOMETRY_BUDGET_US microseconds.
+#define ODOMETRY_PERIOD 10
+#define ODOMETRY_BUDGET_US 200
+
+// how many ticks (right wheels' average minus left wheels' average, divided by two) the
+// wheels count when the robot turns one full circle on the spot. To measure it, turn the
+// robot 10 times and divide by 10.
+#define ODOMETRY_TICKS_PER_TURN 1620
+
+// heading filter tuning, in (mdeg/s)^2: how unsure we are of the gyro bias at first, how much
+// it may wander each update, and how noisy the wheels' turn rate is. If the wheels and gyro
+// disagree by more than ODOMETRY_SLIP_LIMIT mdeg/s, a wheel must be slipping, so the wheels
+// are ignored for that update.
+#define ODOMETRY_INITIAL_VARIANCE 4000000
+#define ODOMETRY_BIAS_WANDER 4
+#define ODOMETRY_WHEEL_VARIANCE 25000000
+#define ODOMETRY_SLIP_LIMIT 20000
+
+// controller buttons for field-centric driving (button group 8 on joystick 1)
+#define FIELD_CENTRIC_BUTTON_GROUP 8
+#define FIELD_CENTRIC_TOGGLE_BUTTON JOY_UP
+#define HEADING_RESET_BUTTON JOY_DOWN
+
+// quadrature encoders on each drive wheel, read with interrupts. Pins must be 1-9, 11 or 12
+// (pin 10 can't interrupt), and pin 3 is the autonomous LED.
+#define QUAD_FRONT_LEFT 0
+#define QUAD_BACK_LEFT 1
+#define QUAD_FRONT_RIGHT 2
+#define QUAD_BACK_RIGHT 3
+#define QUAD_NUM_ENCODERS 4
+
+#define PORT_QUAD_FRONT_LEFT_A 1
+#define PORT_QUAD_FRONT_LEFT_B 2
+#define PORT_QUAD_BACK_LEFT_A 4
+#define PORT_QUAD_BACK_LEFT_B 5
+#define PORT_QUAD_FRONT_RIGHT_A 6
+#define PORT_QUAD_FRONT_RIGHT_B 7
+#define PORT_QUAD_BACK_RIGHT_A 8
+#define PORT_QUAD_BACK_RIGHT_B 9
+
+// encoders on the right side are mounted facing the other way.
+#define QUAD_ORIENTATION_FRONT_LEFT PORT_ORIENTATION_NORMAL
+#define QUAD_ORIENTATION_BACK_LEFT PORT_ORIENTATION_NORMAL
+#define QUAD_ORIENTATION_FRONT_RIGHT PORT_ORIENTATION_REVERSED
+#define QUAD_ORIENTATION_BACK_RIGHT PORT_ORIENTATION_REVERSED
+
+// each encoder remembers up to QUAD_RING_SIZE edges between control cycles (must be a power
+// of two). A wheel with no edges for QUAD_STOPPED_US microseconds is considered stopped.
+#define QUAD_RING_SIZE 64
+#define QUAD_STOPPED_US 100000
+
+// fixed-point math: FIXED_ONE stands for 1.0
+#define FIXED_SHIFT 14
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+// stages of a drive cycle that the latency monitor timestamps, in the order they happen.
+#define LATENCY_SAMPLE 0   // joystick has been read
+#define LATENCY_MIX 1      // motor powers have been worked out
+#define LATENCY_OUTPUT 2   // all motorSet() calls are done
+#define LATENCY_NUM_STAGES 3
+
+// the time spans the latency monitor keeps statistics for.
+#define LATENCY_SEGMENT_SAMPLE_TO_MIX 0
+#define LATENCY_SEGMENT_MIX_TO_OUTPUT 1
+#define LATENCY_SEGMENT_TOTAL 2
+#define LATENCY_NUM_SEGMENTS 3
+
+// latency histogram: LATENCY_BUCKETS buckets, each LATENCY_BUCKET_US microseconds wide. The
+// last bucket catches everything slower than that.
+#define LATENCY_BUCKETS 32
+#define LATENCY_BUCKET_US 10
+
+// how often the drive loop (opcontrol.c) and the autonomous loop (auto.c) run, in ms. Both
+// stop the robot if they miss (Deadline.c), so neither should be so short that an ordinary
+// hiccup in scheduling counts; the motors only take a new power every ~18 ms anyway.
+#define DRIVE_PERIOD 20
+#define AUTO_PERIOD 10
+
+// static memory (Arena.c, in the core library): ARENA_SIZE bytes set aside below the kernel
+// heap (in its own section; see firmware/cortex.ld) by K_ARENA() in init.c, for the object
+// pools and anything else that needs memory for good.
+#define ARENA_SIZE 14336
+
+// match log (MatchLog.c): a record every MATCH_LOG_PERIOD ms while enabled, up to
+// MATCH_LOG_RECORDS of them (a power of two, 16 bytes each, from the arena) queued until the
+// robot has been disabled for MATCH_LOG_SETTLE ms; then they are written MATCH_LOG_BATCH at a
+// time to the next of MATCH_LOG_FILES files (at most 10). The log task checks every
+// MATCH_LOG_CHECK_PERIOD ms. Change the version whenever the records change.
+// The whole of a match (MATCH_LOG_MATCH_TIME ms: 15 s autonomous and 1:45 driver control)
+// has to fit, as nothing is written until the end, with a quarter again to spare for the
+// extra records events take (MATCH_LOG_RECORDS_NEEDED; MatchLog.c checks). 250 ms would need
+// 1024 records, 16 KB - more than the arena can spare.
+#define MATCH_LOG_MATCH_TIME 120000
+#define MATCH_LOG_PERIOD 500
+#define MATCH_LOG_RECORDS_NEEDED (MATCH_LOG_MATCH_TIME / MATCH_LOG_PERIOD * 5 / 4)
+#define MATCH_LOG_RECORDS 512
+#define MATCH_LOG_SETTLE 500
+#define MATCH_LOG_BATCH 32
+#define MATCH_LOG_FILES 4
+#define MATCH_LOG_CHECK_PERIOD 100
+#define MATCH_LOG_VERSION 1
+
+// things matchLogEvent() can mark
+#define MATCH_LOG_EVENT_AUTONOMOUS 0x01    // the autonomous routine started
+#define MATCH_LOG_EVENT_DRIVER 0x02        // driver control started
+#define MATCH_LOG_EVENT_FIELD_CENTRIC 0x04 // field-centric driving was switched on or off
+#define MATCH_LOG_EVENT_HEADING_RESET 0x08 // the driver reset the heading
+#define MATCH_LOG_EVENT_DEADLINE_TRIP 0x10 // a task kept missing its deadline (deadlineOnTrip())
+#define MATCH_LOG_EVENT_DROPPED 0x20       // records were lost just before this one
+
+// bits in each record's flags
+#define MATCH_LOG_FLAG_AUTONOMOUS 0x01
+#define MATCH_LOG_FLAG_FIELD_CENTRIC 0x02
+
+// the longest line the serial console will accept
+#define CONSOLE_LINE_LENGTH 64
+
+// which page the LCD is showing; the LCD's center button flips between them.
+#define LCD_PAGE_DRIVE 0
+#define LCD_PAGE_LATENCY 1
+#define LCD_PAGE_CPU 2
+#define LCD_NUM_PAGES 3
 
-#include <API.h>
+
+#include <kcore.h>
+#include "TelemetryFrame.h"
 // Allow usage of this file in C++ programs
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * a set of readings from the analog sampler: value[0] is port 1, etc. Each value is 0-65535,
+ * 16 times the scale of analogRead(). timestamp is the millis() time they were published.
+ */
+typedef struct {
+	int value[BOARD_NR_ADC_PINS];
+	unsigned long timestamp;
+} AnalogSamples;
+
+/**
+ * the cached state of one IME. count and velocity are as imeGet() and imeGetVelocity() give
+ * them; timestamp is the millis() time of the last good read (0 if it never answered).
+ */
+typedef struct {
+	int count;
+	int velocity;
+	unsigned long timestamp;
+	unsigned int errors; // reads that have failed, ever
+	bool ok;             // did the most recent read work?
+} ImeReading;
+
+// SENSOR_HEADING, SENSOR_TURN_RATE, ... one for each entry in SENSOR_LIST, then SENSOR_COUNT.
+#define SENSOR_ID(name, type, port, port2, period) SENSOR_##name,
+enum { SENSOR_LIST(SENSOR_ID) SENSOR_COUNT };
+#undef SENSOR_ID
+
+// PARAM_DEADBAND, PARAM_AUTO_AHEAD_TIME, ... one for each entry in PARAMETER_LIST, then
+// PARAM_COUNT.
+#define PARAMETER_ID(name, type, defaultValue, min, max) PARAM_##name,
+enum { PARAMETER_LIST(PARAMETER_ID) PARAM_COUNT };
+#undef PARAMETER_ID
+
+/**
+ * statistics about one part of the drive cycle, all in microseconds.
+ */
+typedef struct {
+	unsigned long min;
+	unsigned long max;
+	unsigned long total; // used to work out the mean
+	unsigned long count;
+	unsigned long histogram[LATENCY_BUCKETS];
+} LatencyStats;
+
+/**
+ * one command understood by the serial console. run() is given whatever was typed after the
+ * command name (or "" if nothing was).
+ */
+typedef struct {
+	const char *name;
+	const char *description;
+	void (*run)(const char *args);
+} ConsoleCommand;
+
+/**
+ * what the robot is trying to do right now, shared between tasks (RobotState.c). Read it with
+ * robotStateGet(); only the task that is driving may change it.
+ */
+typedef struct {
+	int x_motion;            // the left/right "drift" wanted (-127, 127)
+	int y_motion;            // the forward/backward "drive" wanted (-127, 127)
+	int angle_motion;        // the rotational "twist" wanted (-127, 127)
+	int heading;             // whole degrees counter-clockwise, from the odometry loop
+	bool ledOn;              // the LED on digital pin 3
+	unsigned long timestamp; // millis() when this was published
+} RobotState;
+
 // A function prototype looks exactly like its declaration, but with a semicolon instead of
 // actual code. If a function does not match a prototype, compile errors will occur.
 
@@ -113,24 +396,6 @@ void initialize();
 void operatorControl();
 
 // --------------------------   Common motor functions to be implemented in SharedMotorControl
-/**
- *  turns on the given motor at the current power level - just like motorSet, but incorporates
- *  MOTOR_DIRECTION so we can assume positive is always forward.
- */
-void K_setMotor(int whichPort, int power);
-
-/*
- * determines the current setting for thie given motor, -128 <-> + 128. Based on the
- * DIRECTION_MODIFIERS, so it is compatible with K_setMotor.
- */
-int K_getMotor(int whichPort);
-
-/**
- * sets the motor to power level 1 or -1, so the motor is free to rotate (as opposed to 0,
- * which puts on the brakes). If the motor is already set to zero, it stays at zero.
- */
-void K_floatMotor(int whichPort);
-
 /**
  * restricts the motor's power to be within -127 to +127, just in case we are
  trying to apply power out of that range. Also latches power settings that are
@@ -183,10 +448,362 @@ void allStop();
 void backFull();
 
 /*
-*  based on the state of the global variables, update the motors.
+*  based on the shared robot state, update the motors.
 */
 void auton_process_motors();
 
+// -------------------------  Methods in FieldCentric.c --------------------------
+// is the driver currently in field-centric mode?
+extern bool fieldCentricEnabled;
+
+/**
+ * the sine of the given angle (in whole degrees, any sign or size), multiplied by FIXED_ONE.
+ */
+int fixedSin(int degrees);
+
+/**
+ * the cosine of the given angle (in whole degrees, any sign or size), multiplied by FIXED_ONE.
+ */
+int fixedCos(int degrees);
+
+/**
+ * converts a motion request given relative to the field into one relative to the robot.
+ * x_motion, y_motion - the requested left/right and forward/backward motion; these are
+ *                      overwritten with the rotated values.
+ * heading - which way the robot is facing, in degrees counter-clockwise from where it faced
+ *           when the gyro was last reset.
+ */
+void rotateToRobotFrame(int *x_motion, int *y_motion, int heading);
+
+/**
+ * watches the driver's controller for the field-centric buttons: one toggles field-centric
+ * mode on and off, the other tells the robot that "the way I'm facing now is forward."
+ */
+void checkFieldCentricButtons();
+
+// -------------------------  Methods in AnalogSampler.c --------------------------
+/**
+ * starts the sampler. Call from initialize() before anything that reads analog ports. The
+ * first set of values is ready when this returns.
+ */
+void analogSamplerInit();
+
+/**
+ * copies the latest values for all ports (port 1 in value[0]) and when they were published.
+ * Never waits for the sampler.
+ */
+void analogSamplesGet(AnalogSamples *copy);
+
+/**
+ * the latest filtered value of one analog port (1-8), 0-65535 (16 times analogRead()'s scale).
+ */
+int analogSampleGet(unsigned char port);
+
+// -------------------------  Methods in ImeCache.c --------------------------
+/**
+ * finds the IMEs (with imeInitializeAll()) and starts sweeping them. Call once, from
+ * initialize(). Returns how many IMEs were found; only the first IME_CACHE_MAX are used,
+ * since the chain gets unreliable beyond that.
+ */
+unsigned int imeCacheInit();
+
+/**
+ * copies the latest reading of the IME at the given address. Returns false if there is no
+ * IME at that address.
+ */
+bool imeCachedReading(unsigned char address, ImeReading *reading);
+
+/**
+ * like imeGet(), but answered from the cache without touching the bus. If age is not NULL,
+ * it is set to how many milliseconds old the count is. Returns false if there is no IME at
+ * that address, or it has never answered.
+ */
+bool imeCachedGet(unsigned char address, int *value, unsigned long *age);
+
+/**
+ * like imeGetVelocity(), but answered from the cache. Works the same way as imeCachedGet().
+ */
+bool imeCachedVelocity(unsigned char address, int *value, unsigned long *age);
+
+/**
+ * prints every IME's cached reading, its age and how many reads have failed.
+ */
+void imeCacheReport(PROS_FILE *stream);
+
+// -------------------------  Methods in RobotSensors.c --------------------------
+/**
+ * reads one of this robot's own kinds of sensor (SENSOR_TYPE_GYRO_HEADING and so on) for the
+ * sensor registry. Pass it to sensorRegistryInit().
+ */
+bool readRobotSensor(const SensorConfig *sensor, int *value);
+
+// -------------------------  Methods in Odometry.c --------------------------
+/**
+ * starts the odometry loop. Call from initialize(), after the sensor registry.
+ */
+void odometryInit();
+
+/**
+ * which way the robot is facing, in millidegrees counter-clockwise: the gyro's heading with
+ * the bias the wheels have revealed taken out.
+ */
+int odometryHeadingGet();
+
+/**
+ * makes the way the robot is facing now "zero" (resets the gyro's heading too).
+ */
+void odometryHeadingReset();
+
+/**
+ * prints the filter's state and how long its updates are taking.
+ */
+void odometryReport(PROS_FILE *stream);
+
+// -------------------------  Methods in GyroHeading.c --------------------------
+/**
+ * gets the gyro going. If a good calibration was saved earlier it is used straight away;
+ * otherwise the robot must sit still for about a second while the bias is measured, and the
+ * result is saved for next time. Call once, from initialize().
+ */
+void gyroHeadingInit();
+
+/**
+ * which way the robot is facing, in millidegrees (1/1000 degree) counter-clockwise from where
+ * it faced at the last reset. Keeps counting past 360 degrees.
+ */
+int gyroHeadingGet();
+
+/**
+ * how fast the robot is turning, in millidegrees per second counter-clockwise.
+ */
+int gyroRateGet();
+
+/**
+ * makes the way the robot is facing now "zero." Takes effect at the gyro task's next sample.
+ */
+void gyroHeadingReset();
+
+/**
+ * measures the bias: averages GYRO_CALIBRATION_SAMPLES samples (about a second), and has the
+ * gyro task use it. The robot must be perfectly still, and should be disabled, while this
+ * runs. Does not save - see gyroSaveCalibration().
+ */
+void gyroCalibrateBias();
+
+/**
+ * corrects the multiplier after turning the robot a known amount: reset the heading, turn the
+ * robot (several full turns gives the best answer), then tell this how many degrees it
+ * really turned. Does not save - see gyroSaveCalibration().
+ */
+bool gyroCalibrateScale(int actualDegrees);
+
+/**
+ * writes the current calibration to flash. Only do this while the robot is disabled - the
+ * file system stops most tasks while it writes.
+ */
+bool gyroSaveCalibration();
+
+/**
+ * prints the calibration and current readings.
+ */
+void gyroReport(PROS_FILE *stream);
+
+// -------------------------  Methods in LatencyMonitor.c --------------------------
+// statistics for each LATENCY_SEGMENT_...
+extern LatencyStats latencyStats[LATENCY_NUM_SEGMENTS];
+
+/**
+ * records that the drive loop has just reached the given stage (LATENCY_SAMPLE, LATENCY_MIX or
+ * LATENCY_OUTPUT). Reaching LATENCY_OUTPUT finishes the cycle and updates the statistics.
+ */
+void latencyMark(int stage);
+
+/**
+ * forgets everything measured so far.
+ */
+void latencyReset();
+
+/**
+ * the average latency for the given statistics, in microseconds.
+ */
+unsigned long latencyMean(const LatencyStats *stats);
+
+/**
+ * estimates the 99th percentile latency from the histogram - 99% of cycles were at least this
+ * fast. The answer is the top edge of a histogram bucket, so it is rounded up to the next
+ * LATENCY_BUCKET_US.
+ */
+unsigned long latencyP99(const LatencyStats *stats);
+
+/**
+ * prints a table of the latency statistics, plus the end-to-end histogram, to the given
+ * stream (e.g. stdout).
+ */
+void latencyReport(PROS_FILE *stream);
+
+/**
+ * shows the end-to-end latency on the given line of the LCD.
+ */
+void latencyShowOnLCD(unsigned char line);
+
+// -------------------------  Methods in Console.c --------------------------
+/**
+ * starts the console task. Call once, from initialize().
+ */
+void consoleInit();
+
+/**
+ * finds and runs the command typed on one line. The first word is the command; anything after
+ * it is handed to the command as its arguments.
+ */
+void consoleRunLine(char *line);
+
+// -------------------------  Methods in QuadratureEncoder.c --------------------------
+/**
+ * sets up the interrupts for every encoder listed in main.h. Call once, from initialize().
+ */
+void quadEncoderInit();
+
+/**
+ * how many ticks the given encoder (QUAD_FRONT_LEFT etc.) has counted since the robot started.
+ * Positive is forward. Safe to call from any task.
+ */
+int quadEncoderGet(int which);
+
+/**
+ * empties the given encoder's ring and works out its speed in ticks per second from the
+ * time between edges. Only ONE task may call this - it is the ring's only reader. That task
+ * is the sensor registry; everybody else should use its snapshot.
+ */
+int quadEncoderUpdateVelocity(int which);
+
+/**
+ * the speed worked out by the last quadEncoderUpdateVelocity() call, in ticks per second.
+ */
+int quadEncoderVelocity(int which);
+
+/**
+ * prints each encoder's count, speed, and any edges that were dropped or skipped.
+ */
+void quadEncoderReport(PROS_FILE *stream);
+
+// -------------------------  Methods in RobotState.c --------------------------
+/**
+ * copies the latest robot state. Safe to call from any task; never waits.
+ */
+void robotStateGet(RobotState *copy);
+
+/**
+ * starts a change to the robot state: returns a copy of the current state for the writer to
+ * change as it likes. Nobody else sees the changes until robotStateCommit().
+ */
+RobotState *robotStateBegin();
+
+/**
+ * publishes the changes made since robotStateBegin(), all at once.
+ */
+void robotStateCommit();
+
+/**
+ * sets how the chassis should move, in one update (see manageDriveMotors()).
+ */
+void robotStateSetMotion(int x_motion, int y_motion, int angle_motion);
+
+// -------------------------  Methods in RobotTelemetry.c --------------------------
+/**
+ * fills in and queues one frame describing this cycle. Call once per cycle from the loop
+ * that drives the motors (and only that loop); extraFlags are added to the frame's flags
+ * (e.g. TELEMETRY_FLAG_AUTONOMOUS). Frames are sent at most every TELEMETRY_PERIOD ms;
+ * calls in between do nothing. Takes a few microseconds, and never waits.
+ */
+void telemetrySample(int extraFlags);
+
+// -------------------------  Methods in MatchLog.c --------------------------
+/**
+ * marks that something happened (MATCH_LOG_EVENT_... bits); it is saved with the next record,
+ * which is taken straight away rather than waiting for MATCH_LOG_PERIOD. Any task may call
+ * this.
+ */
+void matchLogEvent(int events);
+
+/**
+ * queues a record of what the robot is doing, if it is time for one. Call once per cycle from
+ * the loop that drives the motors (and only that loop). Never touches flash, and never waits.
+ */
+void matchLogSample();
+
+/**
+ * sets aside the record queue, works out which log file to write next, and starts the log
+ * task. Call once, from initialize().
+ */
+void matchLogInit();
+
+/**
+ * prints how much is queued, how much has been saved, and any problems.
+ */
+void matchLogReport(PROS_FILE *stream);
+
+/**
+ * prints every saved log file, oldest first, as comma-separated values (one line per record).
+ */
+void matchLogDump(PROS_FILE *stream);
+
+// -------------------------  Methods in Parameters.c --------------------------
+/**
+ * loads the saved parameters, or if there are none (or they don't fit this code) the
+ * defaults. Call once, from initialize(), before the control loops start.
+ */
+void parametersInit();
+
+/**
+ * picks up any parameter changes since the last call. Call at the start of each cycle of a
+ * control loop, so every cycle runs with one consistent set of values.
+ */
+void parametersApply();
+
+/**
+ * the value of parameter id (PARAM_...) that the control loops are using.
+ */
+int paramGet(int id);
+
+/**
+ * finds a parameter by name (upper or lower case). Returns its id, or -1 if there isn't one.
+ */
+int paramFind(const char *name);
+
+/**
+ * changes parameter id to value; the control loops pick it up at the start of their next
+ * cycle. Returns false (and changes nothing) if value is outside the parameter's range. Only
+ * the console task may call this.
+ */
+bool paramSet(int id, int value);
+
+/**
+ * prints parameter id: its value, its range and default, and whether a change is waiting.
+ * Only the console task may call this.
+ */
+void paramReport(PROS_FILE *stream, int id);
+
+/**
+ * puts every parameter back to its default (the control loops pick them up at the start of
+ * their next cycle). Doesn't save. Only the console task may call this.
+ */
+void paramSetDefaults();
+
+/**
+ * writes every parameter's latest value to flash, if any have changed since they were last
+ * saved. Only do this while the robot is disabled - the file system stops most tasks while
+ * it writes. Returns false if the file couldn't be written. Only the console task may call
+ * this.
+ */
+bool parametersSave();
+
+/**
+ * prints every parameter, and where the values came from. Only the console task may call
+ * this.
+ */
+void parametersReport(PROS_FILE *stream);
+
 
 
 
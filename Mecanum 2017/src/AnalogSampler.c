@@ -0,0 +1,130 @@
+/** @file AnalogSampler.c
+ * @brief Reads every analog port in the background, averages and filters the readings
+ *
+ * Instead of each piece of code calling analogRead() whenever it likes, this task visits all
+ * BOARD_NR_ADC_PINS ports every millisecond, ANALOG_OVERSAMPLE times each. After
+ * ANALOG_DECIMATION milliseconds it adds up the 16 readings it has for each port - which is
+ * a 16-bit number, like analogReadCalibratedHR() gives, but with the noise averaged out - and
+ * runs it through that port's smoothing filter (ANALOG_FILTER_SHIFT_n in main.h).
+ *
+ * The results are published as a whole array at a time, into one of two copies, so readers
+ * never have to wait and always get all eight ports from the same moment.
+ */
+
+#include "main.h"
+
+// how much smoothing each port gets, in ANALOG_FILTER_SHIFT_n order (port 1 first).
+static const int FILTER_SHIFT[] = {ANALOG_FILTER_SHIFT_1,
+                                   ANALOG_FILTER_SHIFT_2,
+                                   ANALOG_FILTER_SHIFT_3,
+                                   ANALOG_FILTER_SHIFT_4,
+                                   ANALOG_FILTER_SHIFT_5,
+                                   ANALOG_FILTER_SHIFT_6,
+                                   ANALOG_FILTER_SHIFT_7,
+                                   ANALOG_FILTER_SHIFT_8};
+
+// running totals for the readings in the current decimation period.
+static int sums[BOARD_NR_ADC_PINS];
+static int ticks = 0;
+
+// each port's filter state, in 1/256ths of the 16-bit value so small changes aren't lost.
+static int filterState[BOARD_NR_ADC_PINS];
+
+// the published results.
+MAILBOX_DECLARE(AnalogMailbox, AnalogSamples)
+static AnalogMailbox samples;
+
+// the profiler's id for this task's work.
+static int profileId;
+
+// this task's deadline (Deadline.c).
+static int deadlineId;
+
+/**
+ * hands the finished totals to each port's filter and publishes the results.
+ */
+static void publish()
+{
+	AnalogSamples *spare = AnalogMailboxBegin(&samples);
+	for (int i = 0; i < BOARD_NR_ADC_PINS; i++)
+	{
+		// an IIR ("exponential") filter: move 1/2^shift of the way to the new value.
+		filterState[i] += ((sums[i] << 8) - filterState[i]) >> FILTER_SHIFT[i];
+		spare->value[i] = filterState[i] >> 8;
+		sums[i] = 0;
+	}
+	spare->timestamp = millis();
+	AnalogMailboxCommit(&samples);
+}
+
+/**
+ * reads every port ANALOG_OVERSAMPLE times; every ANALOG_DECIMATION calls, publishes.
+ */
+static void sampleAll()
+{
+	// go round all the ports, then round again, so repeat readings of a port are spread out.
+	for (int pass = 0; pass < ANALOG_OVERSAMPLE; pass++)
+		for (int i = 0; i < BOARD_NR_ADC_PINS; i++)
+			sums[i] += analogRead(i + 1);
+
+	if (++ticks < ANALOG_DECIMATION)
+		return;
+	ticks = 0;
+	publish();
+}
+
+/**
+ * the sampler task: one round of sampling every millisecond.
+ */
+static void analogTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	while (true)
+	{
+		profileStart(profileId);
+		sampleAll();
+		profileStop(profileId);
+		deadlineWait(deadlineId, &wakeTime, ANALOG_SAMPLE_PERIOD);
+	}
+}
+
+/**
+ * starts the sampler. Call from initialize() before anything that reads analog ports. The
+ * first set of values is ready when this returns.
+ */
+void analogSamplerInit()
+{
+	// start every filter at the port's current value, rather than ramping up from zero.
+	for (int tick = 0; tick < ANALOG_DECIMATION; tick++)
+		for (int pass = 0; pass < ANALOG_OVERSAMPLE; pass++)
+			for (int i = 0; i < BOARD_NR_ADC_PINS; i++)
+				sums[i] += analogRead(i + 1);
+	for (int i = 0; i < BOARD_NR_ADC_PINS; i++)
+		filterState[i] = sums[i] << 8;
+	publish();
+
+	// above the tasks that use the values, so sampling stays on time.
+	profileId = profileRegister("analog");
+	deadlineId = deadlineRegister("analog", DEADLINE_ACTION_SHED);
+	taskCreateMonitored("analog", analogTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_DEFAULT + 2);
+}
+
+/**
+ * copies the latest values for all ports (port 1 in value[0]) and when they were published.
+ * Never waits for the sampler.
+ */
+void analogSamplesGet(AnalogSamples *copy)
+{
+	AnalogMailboxRead(&samples, copy);
+}
+
+/**
+ * the latest filtered value of one analog port (1-8), 0-65535 (16 times analogRead()'s scale).
+ */
+int analogSampleGet(unsigned char port)
+{
+	AnalogSamples copy;
+	AnalogMailboxRead(&samples, &copy);
+	return copy.value[port - 1];
+}
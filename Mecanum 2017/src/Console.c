@@ -0,0 +1,291 @@
+/** @file Console.c
+ * @brief Simple text commands over the USB/serial link
+ *
+ * Type a command into the PROS terminal (e.g. "latency") and press enter. The console runs
+ * in its own low-priority task, so waiting for typing - or printing a long report - never
+ * holds up the drive loop.
+ */
+
+#include "main.h"
+#include <string.h>
+
+/**
+ * prints the list of commands.
+ */
+static void helpCommand(const char *args);
+
+/**
+ * "latency" prints the latency report; "latency reset" starts measuring again.
+ */
+static void latencyCommand(const char *args)
+{
+	if (strcmp(args, "reset") == 0)
+	{
+		latencyReset();
+		printf("latency statistics cleared\r\n");
+	}
+	else
+		latencyReport(stdout);
+}
+
+/**
+ * "encoders" prints the count and speed of each wheel encoder.
+ */
+static void encodersCommand(const char *args)
+{
+	quadEncoderReport(stdout);
+}
+
+/**
+ * "sensors" prints the latest snapshot of every sensor.
+ */
+static void sensorsCommand(const char *args)
+{
+	sensorReport(stdout);
+}
+
+/**
+ * "imes" prints the cached reading of every IME.
+ */
+static void imesCommand(const char *args)
+{
+	imeCacheReport(stdout);
+}
+
+/**
+ * "odometry" prints the heading filter's state and timing.
+ */
+static void odometryCommand(const char *args)
+{
+	odometryReport(stdout);
+}
+
+/**
+ * "gyro" prints the gyro calibration and heading.
+ */
+static void gyroCommand(const char *args)
+{
+	gyroReport(stdout);
+}
+
+/**
+ * "stacks" prints how much of its stack each task has used.
+ */
+static void stacksCommand(const char *args)
+{
+	stackReport(stdout);
+}
+
+/**
+ * "cpu" prints how much of the processor each task used over the last second.
+ */
+static void cpuCommand(const char *args)
+{
+	profileReport(stdout);
+}
+
+/**
+ * "deadlines" prints how often each periodic task has run late.
+ */
+static void deadlinesCommand(const char *args)
+{
+	deadlineReport(stdout);
+}
+
+/**
+ * "memory" prints how much of the static arena and each object pool is in use.
+ */
+static void memoryCommand(const char *args)
+{
+	memoryReport(stdout);
+}
+
+/**
+ * "telemetry" prints how many telemetry frames have been sent and dropped.
+ */
+static void telemetryCommand(const char *args)
+{
+	telemetryReport(stdout);
+}
+
+/**
+ * "matchlog" prints how the match log is doing; "matchlog dump" prints everything saved.
+ */
+static void matchLogCommand(const char *args)
+{
+	if (strcmp(args, "dump") == 0)
+		matchLogDump(stdout);
+	else
+		matchLogReport(stdout);
+}
+
+/**
+ * "param" lists the parameters; "param <name>" shows one; "param <name> <value>" changes it.
+ * "param save" keeps the changes in flash (only while disabled); "param defaults" puts every
+ * parameter back to its default.
+ */
+static void paramCommand(const char *args)
+{
+	if (args[0] == '\0')
+	{
+		parametersReport(stdout);
+		return;
+	}
+	if (strcmp(args, "save") == 0)
+	{
+		if (isEnabled())
+			printf("disable the robot to save the parameters\r\n");
+		else if (parametersSave())
+			printf("parameters saved\r\n");
+		else
+			printf("could not save the parameters\r\n");
+		return;
+	}
+	if (strcmp(args, "defaults") == 0)
+	{
+		paramSetDefaults();
+		printf("every parameter is back to its default ('param save' to keep that)\r\n");
+		return;
+	}
+
+	char name[CONSOLE_LINE_LENGTH];
+	size_t nameLength = strcspn(args, " ");
+	memcpy(name, args, nameLength);
+	name[nameLength] = '\0';
+	const char *value = args + nameLength + strspn(args + nameLength, " ");
+
+	int id = paramFind(name);
+	if (id < 0)
+		printf("no parameter called '%s' - try 'param'\r\n", name);
+	else if (value[0] == '\0')
+		paramReport(stdout, id);
+	else if (!paramSet(id, atoi(value)))
+		printf("%s is out of range\r\n", value);
+	else
+		paramReport(stdout, id);
+}
+
+/**
+ * saves the gyro calibration, but only while the robot is disabled - writing to flash stalls
+ * the other tasks.
+ */
+static void saveGyroCalibration()
+{
+	if (isEnabled())
+		printf("disable the robot to save the calibration\r\n");
+	else if (gyroSaveCalibration())
+		printf("gyro calibration saved\r\n");
+	else
+		printf("could not save the gyro calibration\r\n");
+}
+
+/**
+ * "gyrocal" measures the gyro bias again (keep the robot still!) and saves it.
+ */
+static void gyroCalibrateCommand(const char *args)
+{
+	if (isEnabled())
+	{
+		printf("disable the robot to calibrate the gyro\r\n");
+		return;
+	}
+	printf("measuring gyro bias - keep the robot still\r\n");
+	gyroCalibrateBias();
+	gyroReport(stdout);
+	saveGyroCalibration();
+}
+
+/**
+ * "gyroscale 360" says the robot really turned 360 degrees since the heading was last reset;
+ * the multiplier is corrected to match, and saved.
+ */
+static void gyroScaleCommand(const char *args)
+{
+	if (!gyroCalibrateScale(atoi(args)))
+	{
+		printf("usage: reset the heading, turn the robot, then 'gyroscale <degrees turned>'\r\n");
+		return;
+	}
+	gyroReport(stdout);
+	saveGyroCalibration();
+}
+
+// every command the console understands. Add new commands here.
+static const ConsoleCommand COMMANDS[] = {
+	{"help", "list the commands", helpCommand},
+	{"latency", "joystick-to-motor latency report ('latency reset' to clear)", latencyCommand},
+	{"encoders", "wheel encoder counts and speeds", encodersCommand},
+	{"sensors", "every sensor's latest value and age", sensorsCommand},
+	{"imes", "cached IME counts, velocities and errors", imesCommand},
+	{"odometry", "fused heading, gyro bias estimate and filter timing", odometryCommand},
+	{"gyro", "gyro calibration and heading", gyroCommand},
+	{"gyrocal", "re-measure the gyro bias (robot still) and save it", gyroCalibrateCommand},
+	{"gyroscale", "'gyroscale 360' after turning one full turn: fix and save the multiplier",
+	 gyroScaleCommand},
+	{"stacks", "most stack each task has used, and how much is left", stacksCommand},
+	{"cpu", "each task's share of the processor, and idle time", cpuCommand},
+	{"deadlines", "missed cycles for each periodic task, and degraded mode", deadlinesCommand},
+	{"memory", "static arena and object pool use", memoryCommand},
+	{"telemetry", "binary telemetry frames sent and dropped (UART 2)", telemetryCommand},
+	{"matchlog", "match log status ('matchlog dump' prints the saved log)", matchLogCommand},
+	{"param", "tunable parameters: 'param <name> <value>', 'param save', 'param defaults'",
+	 paramCommand},
+};
+static const int NUM_COMMANDS = sizeof(COMMANDS)/sizeof(COMMANDS[0]);
+
+static void helpCommand(const char *args)
+{
+	for (int i = 0; i < NUM_COMMANDS; i++)
+		printf("%-10s %s\r\n", COMMANDS[i].name, COMMANDS[i].description);
+}
+
+/**
+ * finds and runs the command typed on one line. The first word is the command; anything after
+ * it is handed to the command as its arguments.
+ */
+void consoleRunLine(char *line)
+{
+	// cut off the end-of-line, and split the command name from its arguments.
+	char *end = line + strcspn(line, "\r\n");
+	*end = '\0';
+	char *args = line + strcspn(line, " ");
+	if (*args != '\0')
+		*args++ = '\0';
+
+	if (line[0] == '\0')
+		return;
+
+	for (int i = 0; i < NUM_COMMANDS; i++)
+	{
+		if (strcmp(line, COMMANDS[i].name) == 0)
+		{
+			COMMANDS[i].run(args);
+			return;
+		}
+	}
+	printf("unknown command '%s' - try 'help'\r\n", line);
+}
+
+/**
+ * the console task: waits for a line of text, then runs it.
+ */
+static void consoleTask(void *ignore)
+{
+	char line[CONSOLE_LINE_LENGTH];
+	while (true)
+	{
+		if (fgets(line, sizeof(line), stdin) != NULL)
+			consoleRunLine(line);
+		else
+			delay(50);
+	}
+}
+
+/**
+ * starts the console task. Call once, from initialize().
+ */
+void consoleInit()
+{
+	taskCreateMonitored("console", consoleTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_LOWEST);
+}
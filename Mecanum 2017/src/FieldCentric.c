@@ -0,0 +1,106 @@
+/** @file FieldCentric.c
+ * @brief Field-centric driving for the mecanum base
+ *
+ * In field-centric mode, pushing the joystick "forward" moves the robot away from the driver,
+ * no matter which way the robot is turned. We do this by rotating the joystick's x/y vector
+ * by the robot's heading (from the odometry loop) before it gets to manageDriveMotors().
+ *
+ * All of the math is done with integers - the Cortex has no floating point hardware (the
+ * build uses -mfloat-abi=soft), so sin() and cos() would eat a big chunk of the 20 ms loop.
+ */
+
+#include "main.h"
+
+// sin(0) ... sin(90 degrees), one entry per degree, multiplied by FIXED_ONE (2^14).
+// a driver can't aim a joystick to better than a degree, so a finer table would not buy us
+// anything. The other three quadrants are "folded" back onto this one in fixedSin().
+static const short SINE_TABLE[91] = {
+	    0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+	 2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+	 5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+	 8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+	10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+	12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+	14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+	15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+	16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+	16384};
+
+// is the driver currently in field-centric mode?
+bool fieldCentricEnabled = false;
+
+// was the toggle button held down last time we looked? (so holding it only toggles once.)
+static bool toggleButtonWasDown = false;
+
+// the same for the heading reset button (so holding it only resets, and logs, once).
+static bool resetButtonWasDown = false;
+
+/**
+ * the sine of the given angle (in whole degrees, any sign or size), multiplied by FIXED_ONE.
+ */
+int fixedSin(int degrees)
+{
+	degrees %= 360;
+	if (degrees < 0)
+		degrees += 360;
+
+	if (degrees <= 90)
+		return SINE_TABLE[degrees];
+	if (degrees <= 180)
+		return SINE_TABLE[180 - degrees];
+	if (degrees <= 270)
+		return -SINE_TABLE[degrees - 180];
+	return -SINE_TABLE[360 - degrees];
+}
+
+/**
+ * the cosine of the given angle (in whole degrees, any sign or size), multiplied by FIXED_ONE.
+ */
+int fixedCos(int degrees)
+{
+	return fixedSin((degrees % 360) + 90);
+}
+
+/**
+ * converts a motion request given relative to the field into one relative to the robot.
+ * x_motion, y_motion - the requested left/right and forward/backward motion; these are
+ *                      overwritten with the rotated values.
+ * heading - which way the robot is facing, in degrees counter-clockwise from where it faced
+ *           when the gyro was last reset.
+ */
+void rotateToRobotFrame(int *x_motion, int *y_motion, int heading)
+{
+	int s = fixedSin(heading);
+	int c = fixedCos(heading);
+	int x = *x_motion;
+	int y = *y_motion;
+
+	// FIXED_ONE/2 rounds to the nearest whole power level, rather than always rounding down.
+	*x_motion = (x * c + y * s + FIXED_ONE / 2) >> FIXED_SHIFT;
+	*y_motion = (y * c - x * s + FIXED_ONE / 2) >> FIXED_SHIFT;
+}
+
+/**
+ * watches the driver's controller for the field-centric buttons: one toggles field-centric
+ * mode on and off, the other tells the robot that "the way I'm facing now is forward."
+ */
+void checkFieldCentricButtons()
+{
+	bool toggleButtonIsDown = joystickGetDigital(1, FIELD_CENTRIC_BUTTON_GROUP,
+	                                             FIELD_CENTRIC_TOGGLE_BUTTON);
+	if (toggleButtonIsDown && !toggleButtonWasDown)
+	{
+		fieldCentricEnabled = !fieldCentricEnabled;
+		matchLogEvent(MATCH_LOG_EVENT_FIELD_CENTRIC);
+	}
+	toggleButtonWasDown = toggleButtonIsDown;
+
+	bool resetButtonIsDown = joystickGetDigital(1, FIELD_CENTRIC_BUTTON_GROUP,
+	                                            HEADING_RESET_BUTTON);
+	if (resetButtonIsDown && !resetButtonWasDown)
+	{
+		odometryHeadingReset();
+		matchLogEvent(MATCH_LOG_EVENT_HEADING_RESET);
+	}
+	resetButtonWasDown = resetButtonIsDown;
+}
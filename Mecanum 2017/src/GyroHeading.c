@@ -0,0 +1,349 @@
+/** @file GyroHeading.c
+ * @brief Our own gyro integration, with a calibration that is saved in flash
+ *
+ * gyroInit() recalibrates every time the robot turns on, and the robot must sit perfectly
+ * still while it does. Instead, we integrate the gyro's analog port ourselves, using the
+ * averaged readings from the analog sampler. The gyro's "bias"
+ * (the reading when it isn't turning) and "multiplier" (how many degrees each reading is
+ * worth) are measured once and saved to the "gyrocal" file, with a CRC so a damaged file
+ * is never trusted. On later boots initialize() just loads them and the gyro is ready
+ * immediately.
+ *
+ * The bias drifts slowly as the gyro warms up, so whenever the robot is sitting still (drive
+ * motors off, and the gyro reading hardly changing) we nudge the bias towards what the gyro
+ * is reading.
+ *
+ * Bias is kept in sixteenths of an ADC count - the same scale the analog sampler uses - so
+ * averaging can find it more precisely than one whole count.
+ *
+ * Once the gyro task is running it is the only one that changes the calibration. It
+ * publishes a copy whenever it does, for saving and reporting; a new bias or multiplier from
+ * the console is handed to it as a request, which it takes up at its next sample.
+ */
+
+#include "main.h"
+#include <stddef.h>
+
+// what is saved in the "gyrocal" file.
+typedef struct {
+	unsigned short version;
+	unsigned short multiplier;
+	int bias;                   // sixteenths of an ADC count
+	unsigned short crc;         // of everything above
+} GyroCalibration;
+
+// the calibration in use. Only the gyro task touches this once it is running.
+static GyroCalibration calibration;
+
+// a copy of it for everybody else, published by the gyro task whenever it changes.
+MAILBOX_DECLARE(CalibrationMailbox, GyroCalibration)
+static CalibrationMailbox published;
+
+// a change to the calibration, for the gyro task to take up.
+typedef struct {
+	unsigned int sequence;     // goes up by one with each request
+	bool setBias;
+	int bias;
+	bool setMultiplier;
+	unsigned short multiplier;
+} CalibrationRequest;
+
+// the latest request, published by the console, and the sequence number of the last one the
+// gyro task has taken up.
+MAILBOX_DECLARE(RequestMailbox, CalibrationRequest)
+static RequestMailbox requests;
+static volatile unsigned int appliedSequence = 0;
+static unsigned int requestSequence = 0;
+
+// the heading, in units of (sixteenths of a count x microseconds); gyroTask() converts it to
+// millidegrees.
+// Only the gyro task touches this.
+static long long angleSum = 0;
+
+// what the gyro task publishes for everybody else. Each is one 32-bit word, so a reader can
+// never see half of an update.
+static volatile int headingMillidegrees = 0;
+static volatile int rateMillidegrees = 0;
+static volatile bool resetRequested = false;
+
+// the profiler's id for this task's work.
+static int profileId;
+
+// this task's deadline (Deadline.c).
+static int deadlineId;
+
+// how many samples in a row have looked "still", and what they added up to.
+static int stillSamples = 0;
+static int stillSum = 0;
+
+/**
+ * turns a reading (in sixteenths of a count, with the bias already taken off) into
+ * millidegrees per second.
+ */
+static int toMillidegreesPerSecond(int reading)
+{
+	return (int)((long long)reading * calibration.multiplier * 1000 /
+	             (GYRO_MULTIPLIER_DIVISOR * 16));
+}
+
+/**
+ * the checksum of a calibration record (everything before the crc field).
+ */
+static unsigned short calibrationCrc(const GyroCalibration *cal)
+{
+	return crc16(cal, offsetof(GyroCalibration, crc), CRC16_INITIAL);
+}
+
+/**
+ * true if the drive motors are all stopped - one of the signs that the robot is not turning.
+ */
+static bool driveMotorsStopped()
+{
+	return K_getMotor(PORT_MOTOR_FRONT_LEFT) == 0 && K_getMotor(PORT_MOTOR_BACK_LEFT) == 0 &&
+	       K_getMotor(PORT_MOTOR_FRONT_RIGHT) == 0 && K_getMotor(PORT_MOTOR_BACK_RIGHT) == 0;
+}
+
+/**
+ * if the robot has been still for a while, moves the bias a little towards the average of
+ * what the gyro read while it was still.
+ */
+static void trackDrift(int raw)
+{
+	int reading = raw - calibration.bias;
+	if (reading > GYRO_STILL_BAND || reading < -GYRO_STILL_BAND || !driveMotorsStopped())
+	{
+		stillSamples = 0;
+		stillSum = 0;
+		return;
+	}
+
+	stillSum += reading;
+	if (++stillSamples < GYRO_STILL_SAMPLES)
+		return;
+
+	calibration.bias += (stillSum / stillSamples) / GYRO_DRIFT_GAIN;
+	stillSamples = 0;
+	stillSum = 0;
+	CalibrationMailboxPublish(&published, &calibration);
+}
+
+/**
+ * takes up the console's latest calibration request, if there is a new one.
+ */
+static void applyRequest()
+{
+	CalibrationRequest request;
+	RequestMailboxRead(&requests, &request);
+	if (request.sequence == appliedSequence)
+		return;
+	if (request.setBias)
+	{
+		calibration.bias = request.bias;
+		stillSamples = 0;
+		stillSum = 0;
+	}
+	if (request.setMultiplier)
+		calibration.multiplier = request.multiplier;
+	CalibrationMailboxPublish(&published, &calibration);
+	appliedSequence = request.sequence;
+}
+
+/**
+ * the gyro task: picks up a gyro reading every GYRO_SAMPLE_PERIOD ms and adds up the angle.
+ */
+static void gyroTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	unsigned long lastSample = micros();
+	while (true)
+	{
+		profileStart(profileId);
+		applyRequest();
+		unsigned long now = micros();
+		int raw = analogSampleGet(PORT_GYRO);
+		int reading = (raw - calibration.bias) * GYRO_ORIENTATION;
+
+		if (resetRequested)
+		{
+			angleSum = 0;
+			resetRequested = false;
+		}
+		angleSum += (long long)reading * (long)(now - lastSample);
+		lastSample = now;
+
+		rateMillidegrees = toMillidegreesPerSecond(reading);
+		headingMillidegrees = (int)(angleSum * calibration.multiplier /
+		                            ((long long)GYRO_MULTIPLIER_DIVISOR * 16 * 1000));
+
+		trackDrift(raw);
+		profileStop(profileId);
+		deadlineWait(deadlineId, &wakeTime, GYRO_SAMPLE_PERIOD);
+	}
+}
+
+/**
+ * tries to load the saved calibration. Returns false if there isn't one, or it is from an
+ * older version of this code, or it is damaged.
+ */
+static bool loadCalibration()
+{
+	GyroCalibration saved;
+	PROS_FILE *file = fopen(GYRO_CALIBRATION_FILE, "r");
+	if (file == NULL)
+		return false;
+	size_t bytesRead = fread(&saved, 1, sizeof(saved), file);
+	fclose(file);
+
+	if (bytesRead != sizeof(saved) || saved.version != GYRO_CALIBRATION_VERSION ||
+	    saved.crc != calibrationCrc(&saved))
+		return false;
+	calibration = saved;
+	return true;
+}
+
+/**
+ * writes a calibration to flash, with its CRC. The record is a copy, so the CRC and the
+ * bytes written are always of the same thing.
+ */
+static bool saveCalibration(GyroCalibration record)
+{
+	record.version = GYRO_CALIBRATION_VERSION;
+	record.crc = calibrationCrc(&record);
+
+	PROS_FILE *file = fopen(GYRO_CALIBRATION_FILE, "w");
+	if (file == NULL)
+		return false;
+	size_t written = fwrite(&record, 1, sizeof(record), file);
+	fclose(file);
+	return written == sizeof(record);
+}
+
+/**
+ * hands a change to the calibration to the gyro task, and waits for it to take it up. Only
+ * call from one task (the console).
+ */
+static void requestCalibration(CalibrationRequest *request)
+{
+	request->sequence = ++requestSequence;
+	RequestMailboxPublish(&requests, request);
+	while (appliedSequence != request->sequence)
+		delay(GYRO_SAMPLE_PERIOD);
+}
+
+/**
+ * averages GYRO_CALIBRATION_SAMPLES samples (about a second). The robot must be perfectly
+ * still while this runs.
+ */
+static int measureBias()
+{
+	long sum = 0;
+	for (int i = 0; i < GYRO_CALIBRATION_SAMPLES; i++)
+	{
+		sum += analogSampleGet(PORT_GYRO);
+		delay(GYRO_SAMPLE_PERIOD);
+	}
+	return (int)(sum / GYRO_CALIBRATION_SAMPLES);
+}
+
+/**
+ * writes the current calibration to flash. Only do this while the robot is disabled - the
+ * file system stops most tasks while it writes.
+ */
+bool gyroSaveCalibration()
+{
+	GyroCalibration current;
+	CalibrationMailboxRead(&published, &current);
+	return saveCalibration(current);
+}
+
+/**
+ * measures the bias: averages GYRO_CALIBRATION_SAMPLES samples (about a second), and has the
+ * gyro task use it. The robot must be perfectly still, and should be disabled, while this
+ * runs. Does not save - see gyroSaveCalibration().
+ */
+void gyroCalibrateBias()
+{
+	CalibrationRequest request = {0};
+	request.setBias = true;
+	request.bias = measureBias();
+	requestCalibration(&request);
+}
+
+/**
+ * corrects the multiplier after turning the robot a known amount: reset the heading, turn the
+ * robot (several full turns gives the best answer), then tell this how many degrees it
+ * really turned. Does not save - see gyroSaveCalibration().
+ */
+bool gyroCalibrateScale(int actualDegrees)
+{
+	int measured = headingMillidegrees;
+	if (measured == 0 || actualDegrees == 0)
+		return false;
+	GyroCalibration current;
+	CalibrationMailboxRead(&published, &current);
+	long long multiplier = (long long)current.multiplier * actualDegrees * 1000 / measured;
+	if (multiplier <= 0 || multiplier > 0xFFFF)
+		return false;
+	CalibrationRequest request = {0};
+	request.setMultiplier = true;
+	request.multiplier = (unsigned short)multiplier;
+	requestCalibration(&request);
+	return true;
+}
+
+/**
+ * gets the gyro going. If a good calibration was saved earlier it is used straight away;
+ * otherwise the robot must sit still for about a second while the bias is measured, and the
+ * result is saved for next time. Call once, from initialize().
+ */
+void gyroHeadingInit()
+{
+	// (the gyro task isn't running yet, so this is the one time calibration is set directly.)
+	if (!loadCalibration())
+	{
+		calibration.multiplier = GYRO_DEFAULT_MULTIPLIER;
+		calibration.bias = measureBias();
+		saveCalibration(calibration);
+	}
+	CalibrationMailboxPublish(&published, &calibration);
+	profileId = profileRegister("gyro");
+	deadlineId = deadlineRegister("gyro", DEADLINE_ACTION_SHED);
+	taskCreateMonitored("gyro", gyroTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_DEFAULT + 1);
+}
+
+/**
+ * which way the robot is facing, in millidegrees (1/1000 degree) counter-clockwise from where
+ * it faced at the last reset. Keeps counting past 360 degrees.
+ */
+int gyroHeadingGet()
+{
+	return headingMillidegrees;
+}
+
+/**
+ * how fast the robot is turning, in millidegrees per second counter-clockwise.
+ */
+int gyroRateGet()
+{
+	return rateMillidegrees;
+}
+
+/**
+ * makes the way the robot is facing now "zero." Takes effect at the gyro task's next sample.
+ */
+void gyroHeadingReset()
+{
+	resetRequested = true;
+}
+
+/**
+ * prints the calibration and current readings.
+ */
+void gyroReport(PROS_FILE *stream)
+{
+	GyroCalibration current;
+	CalibrationMailboxRead(&published, &current);
+	fprintf(stream, "bias %d/16, multiplier %u, heading %d mdeg, rate %d mdeg/s\r\n",
+	        current.bias, current.multiplier, headingMillidegrees, rateMillidegrees);
+}
@@ -0,0 +1,158 @@
+/** @file ImeCache.c
+ * @brief Reads the whole IME chain in one sweep, in the background
+ *
+ * Every imeGet() or imeGetVelocity() is its own trip over the I2C bus, and the calling task
+ * waits for it. With several IMEs read in several places per cycle, that adds up. Instead,
+ * this task sweeps every IME found by imeInitializeAll() once every IME_SAMPLE_PERIOD ms and
+ * keeps the answers; imeCachedGet() and imeCachedVelocity() answer from that copy straight
+ * away, and say how old the answer is.
+ *
+ * If an IME doesn't answer, its last good values are kept (so they get older) and its error
+ * count goes up.
+ */
+
+#include "main.h"
+
+// how many IMEs imeInitializeAll() found.
+static unsigned int numImes = 0;
+
+// the published readings of every IME.
+typedef struct {
+	ImeReading ime[IME_CACHE_MAX];
+} ImeTable;
+
+MAILBOX_DECLARE(ImeMailbox, ImeTable)
+static ImeMailbox table;
+
+// the profiler's id for this task's work.
+static int profileId;
+
+// this task's deadline (Deadline.c).
+static int deadlineId;
+
+/**
+ * reads every IME once and publishes the results.
+ */
+static void sweep()
+{
+	const ImeReading *current = ImeMailboxCurrent(&table)->ime;
+	ImeReading *spare = ImeMailboxBegin(&table)->ime;
+
+	for (unsigned int address = 0; address < numImes; address++)
+	{
+		int count;
+		int velocity;
+		spare[address] = current[address];
+		if (imeGet(address, &count) && imeGetVelocity(address, &velocity))
+		{
+			spare[address].count = count;
+			spare[address].velocity = velocity;
+			spare[address].timestamp = millis();
+			spare[address].ok = true;
+		}
+		else
+		{
+			spare[address].errors++;
+			spare[address].ok = false;
+		}
+	}
+
+	ImeMailboxCommit(&table);
+}
+
+/**
+ * the IME task: one sweep of the chain every IME_SAMPLE_PERIOD ms.
+ */
+static void imeTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	while (true)
+	{
+		profileStart(profileId);
+		sweep();
+		profileStop(profileId);
+		deadlineWait(deadlineId, &wakeTime, IME_SAMPLE_PERIOD);
+	}
+}
+
+/**
+ * finds the IMEs (with imeInitializeAll()) and starts sweeping them. Call once, from
+ * initialize(). Returns how many IMEs were found; only the first IME_CACHE_MAX are used,
+ * since the chain gets unreliable beyond that.
+ */
+unsigned int imeCacheInit()
+{
+	numImes = imeInitializeAll();
+	if (numImes > IME_CACHE_MAX)
+		numImes = IME_CACHE_MAX;
+	if (numImes == 0)
+		return 0;
+
+	sweep();
+	profileId = profileRegister("ime");
+	deadlineId = deadlineRegister("ime", DEADLINE_ACTION_SHED);
+	taskCreateMonitored("ime", imeTask, TASK_DEFAULT_STACK_SIZE, NULL, TASK_PRIORITY_DEFAULT);
+	return numImes;
+}
+
+/**
+ * copies the latest reading of the IME at the given address. Returns false if there is no
+ * IME at that address.
+ */
+bool imeCachedReading(unsigned char address, ImeReading *reading)
+{
+	if (address >= numImes)
+		return false;
+
+	ImeTable copy;
+	ImeMailboxRead(&table, &copy);
+	*reading = copy.ime[address];
+	return true;
+}
+
+/**
+ * like imeGet(), but answered from the cache without touching the bus. If age is not NULL,
+ * it is set to how many milliseconds old the count is. Returns false if there is no IME at
+ * that address, or it has never answered.
+ */
+bool imeCachedGet(unsigned char address, int *value, unsigned long *age)
+{
+	ImeReading reading;
+	if (!imeCachedReading(address, &reading) || reading.timestamp == 0)
+		return false;
+	*value = reading.count;
+	if (age != NULL)
+		*age = millis() - reading.timestamp;
+	return true;
+}
+
+/**
+ * like imeGetVelocity(), but answered from the cache. Works the same way as imeCachedGet().
+ */
+bool imeCachedVelocity(unsigned char address, int *value, unsigned long *age)
+{
+	ImeReading reading;
+	if (!imeCachedReading(address, &reading) || reading.timestamp == 0)
+		return false;
+	*value = reading.velocity;
+	if (age != NULL)
+		*age = millis() - reading.timestamp;
+	return true;
+}
+
+/**
+ * prints every IME's cached reading, its age and how many reads have failed.
+ */
+void imeCacheReport(PROS_FILE *stream)
+{
+	if (numImes == 0)
+		fprintf(stream, "no IMEs found\r\n");
+	for (unsigned int address = 0; address < numImes; address++)
+	{
+		ImeReading reading;
+		imeCachedReading(address, &reading);
+		fprintf(stream, "IME %u: count %d, velocity %d, %lu ms old, %u errors%s\r\n", address,
+		        reading.count, reading.velocity, millis() - reading.timestamp, reading.errors,
+		        reading.ok ? "" : " (last read failed)");
+	}
+}
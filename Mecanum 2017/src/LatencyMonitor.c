@@ -0,0 +1,153 @@
+/** @file LatencyMonitor.c
+ * @brief Measures how long it takes from reading the joystick to changing the motors
+ *
+ * Every drive cycle is stamped (with micros()) at three points: when the joystick is sampled,
+ * when the motor powers have been mixed, and when the last motorSet() is done. The time
+ * between those points is added to a histogram, so we can see the minimum, average and the
+ * 99th-percentile ("almost worst case") latency without storing every sample.
+ *
+ * Everything here is written by the drive loop only; the report functions just read it, so
+ * a report printed while the robot is driving may be off by one sample. That is fine for
+ * a diagnostic.
+ */
+
+#include "main.h"
+#include <string.h>
+
+// the three segments we time, all ending at a later stage than they start.
+static const char *SEGMENT_NAMES[] = {"sample->mix", "mix->motor", "sample->motor"};
+static const int SEGMENT_START[] = {LATENCY_SAMPLE, LATENCY_MIX, LATENCY_SAMPLE};
+static const int SEGMENT_END[] = {LATENCY_MIX, LATENCY_OUTPUT, LATENCY_OUTPUT};
+
+LatencyStats latencyStats[LATENCY_NUM_SEGMENTS];
+
+// the micros() time at which each stage was reached in the current cycle.
+static unsigned long stageTime[LATENCY_NUM_STAGES];
+
+// true between the joystick sample and the motor output; autonomous drives the motors
+// without sampling the joystick, and those cycles should not be counted.
+static bool cycleOpen = false;
+
+/**
+ * adds one measurement (in microseconds) to the given statistics.
+ */
+static void addSample(LatencyStats *stats, unsigned long us)
+{
+	int bucket = us / LATENCY_BUCKET_US;
+	if (bucket >= LATENCY_BUCKETS)
+		bucket = LATENCY_BUCKETS - 1; // the last bucket holds everything that is too slow.
+	stats->histogram[bucket]++;
+
+	if (stats->count == 0 || us < stats->min)
+		stats->min = us;
+	if (us > stats->max)
+		stats->max = us;
+	stats->total += us;
+	stats->count++;
+}
+
+/**
+ * records that the drive loop has just reached the given stage (LATENCY_SAMPLE, LATENCY_MIX or
+ * LATENCY_OUTPUT). Reaching LATENCY_OUTPUT finishes the cycle and updates the statistics.
+ */
+void latencyMark(int stage)
+{
+	stageTime[stage] = micros();
+
+	if (stage == LATENCY_SAMPLE)
+	{
+		cycleOpen = true;
+		return;
+	}
+	if (stage != LATENCY_OUTPUT || !cycleOpen)
+		return;
+
+	cycleOpen = false;
+	for (int i = 0; i < LATENCY_NUM_SEGMENTS; i++)
+		// unsigned subtraction still works when micros() rolls over.
+		addSample(&latencyStats[i], stageTime[SEGMENT_END[i]] - stageTime[SEGMENT_START[i]]);
+}
+
+/**
+ * forgets everything measured so far.
+ */
+void latencyReset()
+{
+	memset(latencyStats, 0, sizeof(latencyStats));
+	cycleOpen = false;
+}
+
+/**
+ * the average latency for the given statistics, in microseconds.
+ */
+unsigned long latencyMean(const LatencyStats *stats)
+{
+	if (stats->count == 0)
+		return 0;
+	return stats->total / stats->count;
+}
+
+/**
+ * estimates the 99th percentile latency from the histogram - 99% of cycles were at least this
+ * fast. The answer is the top edge of a histogram bucket, so it is rounded up to the next
+ * LATENCY_BUCKET_US.
+ */
+unsigned long latencyP99(const LatencyStats *stats)
+{
+	if (stats->count == 0)
+		return 0;
+
+	// how many samples must be at or below the answer? (rounded up)
+	unsigned long needed = (stats->count * 99 + 99) / 100;
+	unsigned long seen = 0;
+	for (int bucket = 0; bucket < LATENCY_BUCKETS - 1; bucket++)
+	{
+		seen += stats->histogram[bucket];
+		if (seen >= needed)
+			return (bucket + 1) * LATENCY_BUCKET_US;
+	}
+	// it landed in the "too slow" bucket; the largest value we saw is our best guess.
+	return stats->max;
+}
+
+/**
+ * prints a table of the latency statistics, plus the end-to-end histogram, to the given
+ * stream (e.g. stdout).
+ */
+void latencyReport(PROS_FILE *stream)
+{
+	fprintf(stream, "segment          count    min   mean    p99    max (us)\r\n");
+	for (int i = 0; i < LATENCY_NUM_SEGMENTS; i++)
+	{
+		const LatencyStats *stats = &latencyStats[i];
+		fprintf(stream, "%-14s %7lu %6lu %6lu %6lu %6lu\r\n", SEGMENT_NAMES[i], stats->count,
+		        stats->min, latencyMean(stats), latencyP99(stats), stats->max);
+	}
+
+	const LatencyStats *total = &latencyStats[LATENCY_SEGMENT_TOTAL];
+	fprintf(stream, "sample->motor histogram:\r\n");
+	for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+	{
+		if (total->histogram[bucket] == 0)
+			continue;
+		if (bucket == LATENCY_BUCKETS - 1)
+			fprintf(stream, "  >=%4d us: %lu\r\n", bucket * LATENCY_BUCKET_US,
+			        total->histogram[bucket]);
+		else
+			fprintf(stream, "  <%5d us: %lu\r\n", (bucket + 1) * LATENCY_BUCKET_US,
+			        total->histogram[bucket]);
+	}
+}
+
+/**
+ * shows the end-to-end latency on the given line of the LCD.
+ */
+void latencyShowOnLCD(unsigned char line)
+{
+	const LatencyStats *total = &latencyStats[LATENCY_SEGMENT_TOTAL];
+	char text[LCD_LINE_LENGTH + 1];
+	K_format(text, sizeof(text), K_UINT(total->min, 0), K_CHAR('/'),
+	         K_UINT(latencyMean(total), 0), K_CHAR('/'), K_UINT(latencyP99(total), 0),
+	         K_STR(" us"));
+	lcdSetText(uart1, line, text);
+}
@@ -0,0 +1,349 @@
+/** @file MatchLog.c
+ * @brief Keeps a record of each match in flash, so it can be looked at after power-off
+ *
+ * While the robot is enabled, the drive and autonomous loops call matchLogSample() every
+ * cycle; every MATCH_LOG_PERIOD ms (or straight away, if something noteworthy just happened)
+ * it copies the heading, battery, joystick and motors into a 16-byte MatchLogRecord and
+ * queues it in RAM. Nothing touches flash while the robot is enabled - PROS stops most tasks
+ * while it writes a file, and says to only write with the motors stopped.
+ *
+ * Once the robot has been disabled for MATCH_LOG_SETTLE ms (after autonomous, and at the end
+ * of the match) the log task writes everything queued to a file, in a few big fwrite() calls.
+ * The files are "mlog0" to "mlog3" (MATCH_LOG_FILES of them) and are used in turn, the oldest
+ * being written over, so flash holds the last few segments - one per disabled period - and
+ * the log doesn't keep growing. (PROS only gets back the space of a file written over at the
+ * next power-on, so flash needs room for a few segments' worth.) Each file is a
+ * MatchLogHeader, the records, and a crc16() of the records.
+ *
+ * Other tasks can mark events (a heading reset) with matchLogEvent(); they are saved with the
+ * next record. Deadline trips are marked through deadlineOnTrip().
+ *
+ * "matchlog" on the console shows how the log is doing; "matchlog dump" prints every saved
+ * segment, oldest first, as comma-separated values to paste into a spreadsheet.
+ */
+
+#include "main.h"
+#include <string.h>
+
+/**
+ * one sample of the robot's state.
+ */
+typedef struct {
+	uint32_t time;      // millis()
+	uint8_t events;     // MATCH_LOG_EVENT_... bits, for what happened since the last record
+	uint8_t flags;      // MATCH_LOG_FLAG_... bits
+	int16_t heading;    // tenths of a degree, counter-clockwise, -1800 to 1800
+	uint8_t battery;    // tenths of a volt
+	int8_t joystick[3]; // x, y, turn
+	int8_t motor[4];    // front left, back left, front right, back right
+} MatchLogRecord;
+
+/**
+ * the start of every log file.
+ */
+typedef struct {
+	char magic[4];      // "MLOG"
+	uint8_t version;    // MATCH_LOG_VERSION
+	uint8_t recordSize; // sizeof(MatchLogRecord)
+	uint16_t session;   // goes up by one each time the robot is turned on
+	uint16_t segment;   // goes up by one each time a file is written, starting at 0
+	uint16_t count;     // how many records follow
+	uint32_t time;      // millis() when the file was written
+} MatchLogHeader;
+
+RING_BUFFER_DECLARE(LogRing, MatchLogRecord, MATCH_LOG_RECORDS)
+
+_Static_assert(MATCH_LOG_RECORDS >= MATCH_LOG_RECORDS_NEEDED,
+               "MATCH_LOG_RECORDS can't hold a whole match (see main.h)");
+_Static_assert((MATCH_LOG_RECORDS & (MATCH_LOG_RECORDS - 1)) == 0,
+               "MATCH_LOG_RECORDS must be a power of two");
+
+// in the arena, as it is big.
+static LogRing *ring = NULL;
+
+// only the drive (or autonomous) loop touches these.
+static unsigned long lastSample = 0;
+static bool droppedSinceLast = false;
+
+// events marked by any task since the last record.
+static volatile unsigned char pendingEvents = 0;
+
+// only the log task touches these.
+static MatchLogRecord batch[MATCH_LOG_BATCH];
+static int nextFile = 0;
+static unsigned short session = 0;
+static unsigned short segment = 0;
+
+// statistics for the "matchlog" report.
+static unsigned long recordsDropped = 0;
+static unsigned long recordsSaved = 0;
+static unsigned int filesWritten = 0;
+static unsigned int writeFailures = 0;
+static unsigned long lastWriteTime = 0; // ms the last file took to write
+
+/**
+ * puts the name of log file n ("mlog0" and so on) into name, which needs room for 6.
+ */
+static void fileName(char *name, int n)
+{
+	strcpy(name, "mlog0");
+	name[4] = '0' + n;
+}
+
+/**
+ * reads the header of log file n. Returns false if there isn't one, or it isn't a log.
+ */
+static bool readHeader(int n, MatchLogHeader *header)
+{
+	char name[6];
+	fileName(name, n);
+	PROS_FILE *file = fopen(name, "r");
+	if (file == NULL)
+		return false;
+	size_t bytesRead = fread(header, 1, sizeof(*header), file);
+	fclose(file);
+	return bytesRead == sizeof(*header) && memcmp(header->magic, "MLOG", 4) == 0 &&
+	       header->version == MATCH_LOG_VERSION && header->recordSize == sizeof(MatchLogRecord);
+}
+
+/**
+ * marks that something happened (MATCH_LOG_EVENT_... bits); it is saved with the next record,
+ * which is taken straight away rather than waiting for MATCH_LOG_PERIOD. Any task may call
+ * this.
+ */
+void matchLogEvent(int events)
+{
+	__sync_fetch_and_or(&pendingEvents, events);
+}
+
+/**
+ * queues a record of what the robot is doing, if it is time for one. Call once per cycle from
+ * the loop that drives the motors (and only that loop). Never touches flash, and never waits.
+ */
+void matchLogSample()
+{
+	if (ring == NULL)
+		return;
+	unsigned long now = millis();
+	if (now - lastSample < MATCH_LOG_PERIOD && pendingEvents == 0)
+		return;
+	lastSample = now;
+
+	RobotState state;
+	SensorSnapshot sensors;
+	robotStateGet(&state);
+	sensorSnapshotGet(&sensors);
+
+	MatchLogRecord record;
+	record.time = now;
+	record.events = __sync_fetch_and_and(&pendingEvents, 0);
+	if (droppedSinceLast)
+		record.events |= MATCH_LOG_EVENT_DROPPED;
+	record.flags = 0;
+	if (isAutonomous())
+		record.flags |= MATCH_LOG_FLAG_AUTONOMOUS;
+	if (fieldCentricEnabled)
+		record.flags |= MATCH_LOG_FLAG_FIELD_CENTRIC;
+
+	int heading = odometryHeadingGet() % 360000;
+	if (heading > 180000)
+		heading -= 360000;
+	else if (heading < -180000)
+		heading += 360000;
+	record.heading = heading / 100;
+	int battery = sensors.reading[SENSOR_BATTERY].value / 100;
+	record.battery = battery > 255 ? 255 : battery;
+	record.joystick[0] = state.x_motion;
+	record.joystick[1] = state.y_motion;
+	record.joystick[2] = state.angle_motion;
+	record.motor[0] = K_getMotor(PORT_MOTOR_FRONT_LEFT);
+	record.motor[1] = K_getMotor(PORT_MOTOR_BACK_LEFT);
+	record.motor[2] = K_getMotor(PORT_MOTOR_FRONT_RIGHT);
+	record.motor[3] = K_getMotor(PORT_MOTOR_BACK_RIGHT);
+
+	droppedSinceLast = !LogRingPush(ring, &record);
+	if (droppedSinceLast)
+		recordsDropped++;
+}
+
+/**
+ * writes every queued record to the next log file. Only call while the robot is disabled.
+ */
+static void writeLog()
+{
+	char name[6];
+	MatchLogHeader header;
+	unsigned long start = millis();
+	unsigned int count = LogRingCount(ring);
+
+	memcpy(header.magic, "MLOG", 4);
+	header.version = MATCH_LOG_VERSION;
+	header.recordSize = sizeof(MatchLogRecord);
+	header.session = session;
+	header.segment = segment;
+	header.count = count;
+	header.time = start;
+
+	fileName(name, nextFile);
+	PROS_FILE *file = fopen(name, "w");
+	if (file == NULL)
+	{
+		// probably out of flash; the records stay queued, to try again next time.
+		writeFailures++;
+		return;
+	}
+	fwrite(&header, 1, sizeof(header), file);
+
+	// in batches, so there are only a few (slow) calls into the file system.
+	unsigned short crc = CRC16_INITIAL;
+	unsigned int left = count;
+	while (left > 0)
+	{
+		unsigned int n = 0;
+		while (n < MATCH_LOG_BATCH && n < left && LogRingPop(ring, &batch[n]))
+			n++;
+		crc = crc16(batch, n * sizeof(MatchLogRecord), crc);
+		fwrite(batch, sizeof(MatchLogRecord), n, file);
+		left -= n;
+	}
+	fwrite(&crc, 1, sizeof(crc), file);
+	fclose(file);
+
+	recordsSaved += count;
+	filesWritten++;
+	segment++;
+	nextFile = (nextFile + 1) % MATCH_LOG_FILES;
+	lastWriteTime = millis() - start;
+}
+
+/**
+ * the log task: once the robot has been disabled for a little while, saves what was queued
+ * while it was enabled.
+ */
+static void matchLogTask(void *ignore)
+{
+	unsigned long disabledSince = millis();
+	bool wasEnabled = false;
+	while (true)
+	{
+		if (isEnabled())
+			wasEnabled = true;
+		else
+		{
+			if (wasEnabled)
+				disabledSince = millis();
+			wasEnabled = false;
+			if (millis() - disabledSince >= MATCH_LOG_SETTLE && LogRingCount(ring) > 0)
+			{
+				writeLog();
+				// whether or not that worked, don't try again until after the next enabled spell.
+				while (!isEnabled())
+					delay(MATCH_LOG_CHECK_PERIOD);
+			}
+		}
+		delay(MATCH_LOG_CHECK_PERIOD);
+	}
+}
+
+/**
+ * notes a deadline trip (see deadlineOnTrip()).
+ */
+static void deadlineTripped(int id)
+{
+	matchLogEvent(MATCH_LOG_EVENT_DEADLINE_TRIP);
+}
+
+/**
+ * sets aside the record queue, works out which log file to write next, and starts the log
+ * task. Call once, from initialize().
+ */
+void matchLogInit()
+{
+	ring = arenaAlloc(sizeof(LogRing));
+	if (ring == NULL)
+		return;
+
+	// carry on from the newest file there is.
+	MatchLogHeader header;
+	long newest = -1;
+	for (int n = 0; n < MATCH_LOG_FILES; n++)
+	{
+		if (!readHeader(n, &header))
+			continue;
+		long age = ((long)header.session << 16) | header.segment;
+		if (age > newest)
+		{
+			newest = age;
+			nextFile = (n + 1) % MATCH_LOG_FILES;
+			session = header.session + 1;
+		}
+	}
+
+	deadlineOnTrip(deadlineTripped);
+	taskCreateMonitored("matchlog", matchLogTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_LOWEST);
+}
+
+/**
+ * prints how much is queued, how much has been saved, and any problems.
+ */
+void matchLogReport(PROS_FILE *stream)
+{
+	if (ring == NULL)
+	{
+		fprintf(stream, "match log off: no room in the arena\r\n");
+		return;
+	}
+	fprintf(stream, "session %u: %u of %d records queued, %lu saved in %u files (last took "
+	        "%lu ms), next file mlog%d\r\n", session, LogRingCount(ring), MATCH_LOG_RECORDS,
+	        recordsSaved, filesWritten, lastWriteTime, nextFile);
+	if (recordsDropped > 0 || writeFailures > 0)
+		fprintf(stream, "%lu records DROPPED (queue full), %u files could not be written\r\n",
+		        recordsDropped, writeFailures);
+}
+
+/**
+ * prints one saved log file's records as comma-separated values.
+ */
+static void dumpFile(PROS_FILE *stream, int n)
+{
+	char name[6];
+	MatchLogHeader header;
+	MatchLogRecord record;
+	if (!readHeader(n, &header))
+		return;
+
+	fileName(name, n);
+	PROS_FILE *file = fopen(name, "r");
+	if (file == NULL)
+		return;
+	fseek(file, sizeof(header), SEEK_SET);
+	unsigned short crc = CRC16_INITIAL;
+	for (unsigned int i = 0; i < header.count; i++)
+	{
+		if (fread(&record, 1, sizeof(record), file) != sizeof(record))
+			break;
+		crc = crc16(&record, sizeof(record), crc);
+		fprintf(stream, "%u,%u,%lu,%u,%u,%d,%u,%d,%d,%d,%d,%d,%d,%d\r\n", header.session,
+		        header.segment, (unsigned long)record.time, record.events, record.flags,
+		        record.heading, record.battery, record.joystick[0], record.joystick[1],
+		        record.joystick[2], record.motor[0], record.motor[1], record.motor[2],
+		        record.motor[3]);
+	}
+	unsigned short savedCrc = 0;
+	if (fread(&savedCrc, 1, sizeof(savedCrc), file) != sizeof(savedCrc) || savedCrc != crc)
+		fprintf(stream, "# %s is damaged or cut short\r\n", name);
+	fclose(file);
+}
+
+/**
+ * prints every saved log file, oldest first, as comma-separated values (one line per record).
+ */
+void matchLogDump(PROS_FILE *stream)
+{
+	fprintf(stream, "session,segment,time,events,flags,heading,battery,joy_x,joy_y,joy_turn,"
+	        "front_left,back_left,front_right,back_right\r\n");
+	// nextFile is the oldest (or empty).
+	for (int i = 0; i < MATCH_LOG_FILES; i++)
+		dumpFile(stream, (nextFile + i) % MATCH_LOG_FILES);
+}
@@ -0,0 +1,177 @@
+/** @file Odometry.c
+ * @brief The odometry loop: a heading that combines the gyro and the wheels
+ *
+ * The gyro and the wheels both know how fast the robot is turning, and each is wrong in its
+ * own way:
+ *  - the gyro is smooth and never slips, but it reads a little bit of turning even when
+ *    there is none (its "bias"), so its heading slowly drifts;
+ *  - the wheels don't drift, but when they slip (pushing, spinning out, mecanum rollers
+ *    skidding) they say the robot turned when it didn't.
+ * So we let the gyro say how fast we are turning, and use the wheels only to work out the
+ * gyro's bias: whenever they agree well enough that nothing is slipping, (gyro rate - wheel
+ * rate) is a noisy measurement of the bias. A Kalman filter averages those measurements,
+ * trusting each one according to how sure it already is, and ignores the ones that are so
+ * far off that a wheel must be slipping. The heading is the gyro's heading with the
+ * estimated bias taken back out.
+ *
+ * Everything is done with integers; the Cortex has no floating point hardware.
+ */
+
+#include "main.h"
+
+// the bias estimate, in 1/256ths of a millidegree per second (BIAS_SHIFT) - each
+// measurement only moves it a tiny amount, which would round away to nothing in whole
+// mdeg/s - and how unsure we are of it (its variance, (mdeg/s)^2). Only the odometry task
+// touches these.
+#define BIAS_SHIFT 8
+static int biasFine = 0;
+static long long biasVariance = ODOMETRY_INITIAL_VARIANCE;
+
+// how far the bias has carried the gyro's heading off, in nanodegrees (mdeg/s x us).
+static long long biasDrift = 0;
+static volatile bool resetRequested = false;
+
+// results, published for other tasks (each a single 32-bit word).
+static volatile int fusedHeading = 0;    // millidegrees counter-clockwise
+static volatile int wheelTurnRate = 0;   // millidegrees per second, from the wheels
+static volatile int gyroTurnRate = 0;    // millidegrees per second, from the same snapshot
+static volatile int publishedBias = 0;   // millidegrees per second
+
+// bookkeeping for the "odometry" console report.
+static unsigned long updates = 0;
+static unsigned long slips = 0;
+static unsigned long slowestUpdate = 0;
+static unsigned long overBudget = 0;
+
+// the profiler's id for this task's work.
+static int profileId;
+
+// this task's deadline (Deadline.c).
+static int deadlineId;
+
+/**
+ * how fast the wheels say the robot is turning, in millidegrees per second counter-clockwise:
+ * the right side going forward and the left going backward turns the robot left. right and
+ * left are each two wheels added up, so (right average - left average) / 2, the measure
+ * ODOMETRY_TICKS_PER_TURN is in, is (right - left) / 4.
+ */
+static int wheelRate(const SensorSnapshot *sensors)
+{
+	int right = sensors->reading[SENSOR_FRONT_RIGHT_SPEED].value +
+	            sensors->reading[SENSOR_BACK_RIGHT_SPEED].value;
+	int left = sensors->reading[SENSOR_FRONT_LEFT_SPEED].value +
+	           sensors->reading[SENSOR_BACK_LEFT_SPEED].value;
+	return (int)((long long)(right - left) * 360000 / (4 * ODOMETRY_TICKS_PER_TURN));
+}
+
+/**
+ * one step of the filter. elapsed is the time since the last step, in microseconds.
+ */
+static void updateHeading(const SensorSnapshot *sensors, unsigned long elapsed)
+{
+	int gyroRate = sensors->reading[SENSOR_TURN_RATE].value;
+	int wheels = wheelRate(sensors);
+
+	// predict: the bias may have wandered a little since last time.
+	biasVariance += ODOMETRY_BIAS_WANDER;
+
+	// measure: if nothing is slipping, gyro rate - wheel rate = bias (plus noise).
+	int bias = biasFine >> BIAS_SHIFT;
+	int innovation = (gyroRate - wheels) - bias;
+	if (innovation > ODOMETRY_SLIP_LIMIT || innovation < -ODOMETRY_SLIP_LIMIT)
+		slips++;
+	else
+	{
+		// gain = how much to believe this measurement, from 0 to FIXED_ONE.
+		int gain = (int)((biasVariance << FIXED_SHIFT) /
+		                 (biasVariance + ODOMETRY_WHEEL_VARIANCE));
+		// (adding half before shifting rounds to nearest; without it, rounding would always
+		// go downwards and slowly drag the bias negative.)
+		const int shift = FIXED_SHIFT - BIAS_SHIFT;
+		biasFine += (int)(((long long)innovation * gain + (1 << (shift - 1))) >> shift);
+		biasVariance = (biasVariance * (FIXED_ONE - gain)) >> FIXED_SHIFT;
+	}
+
+	bias = biasFine >> BIAS_SHIFT;
+	if (resetRequested)
+	{
+		biasDrift = 0;
+		resetRequested = false;
+	}
+	biasDrift += (long long)bias * elapsed;
+
+	// the gyro's heading from the same snapshot as the rates, so all of it is from one moment.
+	fusedHeading = sensors->reading[SENSOR_HEADING].value - (int)(biasDrift / 1000000);
+	wheelTurnRate = wheels;
+	gyroTurnRate = gyroRate;
+	publishedBias = bias;
+}
+
+/**
+ * the odometry loop: updates the heading every ODOMETRY_PERIOD ms from the latest sensors.
+ */
+static void odometryTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	unsigned long lastUpdate = micros();
+	SensorSnapshot sensors;
+	while (true)
+	{
+		profileStart(profileId);
+		unsigned long start = micros();
+		sensorSnapshotGet(&sensors);
+		updateHeading(&sensors, start - lastUpdate);
+		lastUpdate = start;
+
+		// keep an eye on how long the update takes; it has to fit well inside the period.
+		unsigned long took = micros() - start;
+		updates++;
+		if (took > slowestUpdate)
+			slowestUpdate = took;
+		if (took > ODOMETRY_BUDGET_US)
+			overBudget++;
+
+		profileStop(profileId);
+		deadlineWait(deadlineId, &wakeTime, ODOMETRY_PERIOD);
+	}
+}
+
+/**
+ * starts the odometry loop. Call from initialize(), after the sensor registry.
+ */
+void odometryInit()
+{
+	profileId = profileRegister("odometry");
+	deadlineId = deadlineRegister("odometry", DEADLINE_ACTION_SHED);
+	taskCreateMonitored("odometry", odometryTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_DEFAULT + 1);
+}
+
+/**
+ * which way the robot is facing, in millidegrees counter-clockwise: the gyro's heading with
+ * the bias the wheels have revealed taken out.
+ */
+int odometryHeadingGet()
+{
+	return fusedHeading;
+}
+
+/**
+ * makes the way the robot is facing now "zero" (resets the gyro's heading too).
+ */
+void odometryHeadingReset()
+{
+	gyroHeadingReset();
+	resetRequested = true;
+}
+
+/**
+ * prints the filter's state and how long its updates are taking.
+ */
+void odometryReport(PROS_FILE *stream)
+{
+	fprintf(stream, "heading %d mdeg (gyro %d), turning %d mdeg/s (wheels %d), bias %d mdeg/s\r\n",
+	        fusedHeading, gyroHeadingGet(), gyroTurnRate, wheelTurnRate, publishedBias);
+	fprintf(stream, "%lu updates, %lu slips, slowest %lu us, %lu over %d us\r\n", updates,
+	        slips, slowestUpdate, overBudget, ODOMETRY_BUDGET_US);
+}
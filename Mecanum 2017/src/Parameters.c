@@ -0,0 +1,276 @@
+/** @file Parameters.c
+ * @brief Numbers that can be changed over the serial link while the robot runs
+ *
+ * Each entry in PARAMETER_LIST (main.h) has a name, a type, a default and the smallest and
+ * largest values it may take. "param" on the console lists them; "param deadband 15" changes
+ * one, with no rebuild or upload. Nothing outside its range is accepted.
+ *
+ * A change doesn't take effect the moment it is typed. The console publishes a whole new set
+ * of values through a mailbox (RingBuffer.h), and the control loops call parametersApply() at
+ * the start of each cycle, which takes the new set all at once. So a cycle always runs with
+ * one consistent set, and the loops never wait on the console. paramGet() reads the set the
+ * loops are using.
+ *
+ * Changes last until the robot is turned off, unless they are saved with "param save". That
+ * writes every value to the PARAMETER_FILE in flash, with a CRC and a description of the table
+ * (each parameter's name and type) so a file saved by different code isn't misread.
+ * parametersInit() reads it back at start-up in a single fread(); if anything about it is
+ * wrong, every parameter starts at its default instead. Flash is only ever written by "param
+ * save", and only when something has changed.
+ */
+
+#include "main.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * a value for every parameter.
+ */
+typedef struct {
+	int value[PARAM_COUNT];
+} ParameterSet;
+
+MAILBOX_DECLARE(ParameterMailbox, ParameterSet)
+
+/**
+ * what the table says about each parameter.
+ */
+typedef struct {
+	const char *name;
+	int type;
+	int defaultValue;
+	int min;
+	int max;
+} ParameterInfo;
+
+#define PARAMETER_INFO(name, type, defaultValue, min, max) {#name, type, defaultValue, min, max},
+static const ParameterInfo PARAMETERS[] = {
+	PARAMETER_LIST(PARAMETER_INFO)
+};
+#undef PARAMETER_INFO
+
+/**
+ * what is in the PARAMETER_FILE.
+ */
+typedef struct {
+	unsigned short version; // PARAMETER_FILE_VERSION
+	unsigned short count;   // PARAM_COUNT
+	unsigned short schema;  // tableCrc() of the code that saved it
+	int value[PARAM_COUNT];
+	unsigned short crc;     // crc16() of everything above
+} SavedParameters;
+
+// the latest values; only the console task publishes.
+static ParameterMailbox published;
+
+// the values the control loops are using, and which published version they are. Only
+// changed by parametersApply(), from whichever control loop is running.
+static ParameterSet active;
+static unsigned int activeVersion = 0;
+
+// what is in flash (or the defaults, if nothing is); only the console task touches these.
+static ParameterSet saved;
+static bool savedInFlash = false;
+
+/**
+ * a CRC of every parameter's name and type, which changes whenever the table does.
+ */
+static unsigned short tableCrc()
+{
+	unsigned short crc = CRC16_INITIAL;
+	for (int id = 0; id < PARAM_COUNT; id++)
+	{
+		crc = crc16(PARAMETERS[id].name, strlen(PARAMETERS[id].name) + 1, crc);
+		crc = crc16(&PARAMETERS[id].type, sizeof(PARAMETERS[id].type), crc);
+	}
+	return crc;
+}
+
+static unsigned short savedCrc(const SavedParameters *file)
+{
+	return crc16(file, offsetof(SavedParameters, crc), CRC16_INITIAL);
+}
+
+/**
+ * tries to read the saved parameters into values. Returns false if there aren't any, or they
+ * were saved by code with a different table, or they are damaged or out of range.
+ */
+static bool loadParameters(ParameterSet *values)
+{
+	SavedParameters file;
+	PROS_FILE *stream = fopen(PARAMETER_FILE, "r");
+	if (stream == NULL)
+		return false;
+	size_t bytesRead = fread(&file, 1, sizeof(file), stream);
+	fclose(stream);
+
+	if (bytesRead != sizeof(file) || file.version != PARAMETER_FILE_VERSION ||
+	    file.count != PARAM_COUNT || file.schema != tableCrc() || file.crc != savedCrc(&file))
+		return false;
+	for (int id = 0; id < PARAM_COUNT; id++)
+		if (file.value[id] < PARAMETERS[id].min || file.value[id] > PARAMETERS[id].max)
+			return false;
+	memcpy(values->value, file.value, sizeof(values->value));
+	return true;
+}
+
+/**
+ * loads the saved parameters, or if there are none (or they don't fit this code) the
+ * defaults. Call once, from initialize(), before the control loops start.
+ */
+void parametersInit()
+{
+	savedInFlash = loadParameters(&saved);
+	if (!savedInFlash)
+		for (int id = 0; id < PARAM_COUNT; id++)
+			saved.value[id] = PARAMETERS[id].defaultValue;
+	ParameterMailboxPublish(&published, &saved);
+	active = saved;
+	activeVersion = ringLoadAcquire(&published.version);
+}
+
+/**
+ * picks up any parameter changes since the last call. Call at the start of each cycle of a
+ * control loop, so every cycle runs with one consistent set of values.
+ */
+void parametersApply()
+{
+	unsigned int version = ringLoadAcquire(&published.version);
+	if (version == activeVersion)
+		return;
+	ParameterMailboxRead(&published, &active);
+	// (if another change came in while copying, the version will differ again next cycle.)
+	activeVersion = version;
+}
+
+/**
+ * the value of parameter id (PARAM_...) that the control loops are using.
+ */
+int paramGet(int id)
+{
+	return active.value[id];
+}
+
+/**
+ * finds a parameter by name (upper or lower case). Returns its id, or -1 if there isn't one.
+ */
+int paramFind(const char *name)
+{
+	for (int id = 0; id < PARAM_COUNT; id++)
+	{
+		const char *a = PARAMETERS[id].name;
+		const char *b = name;
+		for (; *a != '\0' && *b != '\0'; a++, b++)
+		{
+			char upper = (*b >= 'a' && *b <= 'z') ? *b - 'a' + 'A' : *b;
+			if (*a != upper)
+				break;
+		}
+		if (*a == '\0' && *b == '\0')
+			return id;
+	}
+	return -1;
+}
+
+/**
+ * changes parameter id to value; the control loops pick it up at the start of their next
+ * cycle. Returns false (and changes nothing) if value is outside the parameter's range. Only
+ * the console task may call this.
+ */
+bool paramSet(int id, int value)
+{
+	if (id < 0 || id >= PARAM_COUNT || value < PARAMETERS[id].min || value > PARAMETERS[id].max)
+		return false;
+	ParameterSet *next = ParameterMailboxBegin(&published);
+	*next = *ParameterMailboxCurrent(&published);
+	next->value[id] = value;
+	ParameterMailboxCommit(&published);
+	return true;
+}
+
+/**
+ * puts every parameter back to its default (the control loops pick them up at the start of
+ * their next cycle). Doesn't save. Only the console task may call this.
+ */
+void paramSetDefaults()
+{
+	ParameterSet *next = ParameterMailboxBegin(&published);
+	for (int id = 0; id < PARAM_COUNT; id++)
+		next->value[id] = PARAMETERS[id].defaultValue;
+	ParameterMailboxCommit(&published);
+}
+
+/**
+ * writes every parameter's latest value to flash, if any have changed since they were last
+ * saved. Only do this while the robot is disabled - the file system stops most tasks while
+ * it writes. Returns false if the file couldn't be written. Only the console task may call
+ * this.
+ */
+bool parametersSave()
+{
+	const ParameterSet *latest = ParameterMailboxCurrent(&published);
+	if (savedInFlash && memcmp(latest, &saved, sizeof(saved)) == 0)
+		return true; // nothing has changed; don't wear out the flash
+
+	SavedParameters file;
+	memset(&file, 0, sizeof(file));
+	file.version = PARAMETER_FILE_VERSION;
+	file.count = PARAM_COUNT;
+	file.schema = tableCrc();
+	memcpy(file.value, latest->value, sizeof(file.value));
+	file.crc = savedCrc(&file);
+
+	PROS_FILE *stream = fopen(PARAMETER_FILE, "w");
+	if (stream == NULL)
+		return false;
+	size_t written = fwrite(&file, 1, sizeof(file), stream);
+	fclose(stream);
+	if (written != sizeof(file))
+		return false;
+	saved = *latest;
+	savedInFlash = true;
+	return true;
+}
+
+/**
+ * prints one parameter's value, as the console should show it.
+ */
+static void printValue(PROS_FILE *stream, int id, int value)
+{
+	if (PARAMETERS[id].type == PARAM_TYPE_MS)
+		fprintf(stream, "%d ms", value);
+	else
+		fprintf(stream, "%d", value);
+}
+
+/**
+ * prints parameter id: its value, its range and default, and whether a change is waiting.
+ * Only the console task may call this.
+ */
+void paramReport(PROS_FILE *stream, int id)
+{
+	int latest = ParameterMailboxCurrent(&published)->value[id];
+	fprintf(stream, "%-20s ", PARAMETERS[id].name);
+	printValue(stream, id, latest);
+	fprintf(stream, " (%d to %d, default %d)", PARAMETERS[id].min, PARAMETERS[id].max,
+	        PARAMETERS[id].defaultValue);
+	if (latest != active.value[id])
+		fprintf(stream, " - not picked up yet");
+	if (latest != saved.value[id])
+		fprintf(stream, " - not saved");
+	fprintf(stream, "\r\n");
+}
+
+/**
+ * prints every parameter, and where the values came from. Only the console task may call
+ * this.
+ */
+void parametersReport(PROS_FILE *stream)
+{
+	if (savedInFlash)
+		fprintf(stream, "loaded from flash ('param save' to keep changes)\r\n");
+	else
+		fprintf(stream, "nothing saved: starting from the defaults\r\n");
+	for (int id = 0; id < PARAM_COUNT; id++)
+		paramReport(stream, id);
+}
@@ -0,0 +1,180 @@
+/** @file QuadratureEncoder.c
+ * @brief Interrupt-driven quadrature encoders that remember when every edge happened
+ *
+ * encoderGet() only tells us how far a wheel has turned. To get a good speed out of that we
+ * would have to subtract two counts and divide by the loop time, which is very coarse at slow
+ * speeds (one or two ticks per loop). Instead, an interrupt fires on every edge of both
+ * encoder wires; it updates the count and also writes the micros() time of the edge into a
+ * ring buffer. The sensor registry empties the ring and divides ticks by the time between the
+ * first and last edge, which is precise to a few microseconds.
+ *
+ * Each ring has exactly one writer (the interrupt) and one reader (the registry), so it is
+ * a lock-free ring from RingBuffer.h.
+ */
+
+#include "main.h"
+
+/**
+ * one encoder edge: when it happened, and which way it moved the count.
+ */
+typedef struct {
+	unsigned long time;
+	signed char step;
+} EncoderEdge;
+
+RING_BUFFER_DECLARE(EdgeRing, EncoderEdge, QUAD_RING_SIZE)
+
+// the pins for each encoder, in QUAD_... order. Set in main.h.
+static const unsigned char PINS_A[] = {PORT_QUAD_FRONT_LEFT_A, PORT_QUAD_BACK_LEFT_A,
+                                       PORT_QUAD_FRONT_RIGHT_A, PORT_QUAD_BACK_RIGHT_A};
+static const unsigned char PINS_B[] = {PORT_QUAD_FRONT_LEFT_B, PORT_QUAD_BACK_LEFT_B,
+                                       PORT_QUAD_FRONT_RIGHT_B, PORT_QUAD_BACK_RIGHT_B};
+static const int ORIENTATIONS[] = {QUAD_ORIENTATION_FRONT_LEFT, QUAD_ORIENTATION_BACK_LEFT,
+                                   QUAD_ORIENTATION_FRONT_RIGHT, QUAD_ORIENTATION_BACK_RIGHT};
+
+// how far the count moves for each (old A/B state, new A/B state) pair. Going from 00 to 01,
+// for instance, is one step forward; 00 to 11 means we missed an edge, so we can't tell.
+static const signed char QUADRATURE_STEP[16] = {
+	 0, +1, -1,  0,
+	-1,  0,  0, +1,
+	+1,  0,  0, -1,
+	 0, -1, +1,  0};
+
+typedef struct {
+	volatile int count;   // written only by the interrupt
+	unsigned char state;  // last (A << 1 | B) seen by the interrupt
+	unsigned int dropped; // edges lost because the ring was full
+	unsigned int skipped; // transitions where we missed an edge in between
+	EdgeRing edges;
+
+	// the reader's memory of the last edge it consumed.
+	unsigned long lastEdgeTime;
+	bool haveLastEdge;
+	int velocity;
+} QuadEncoder;
+
+static QuadEncoder encoders[QUAD_NUM_ENCODERS];
+
+// which encoder owns each digital pin (-1 for none), so the interrupt can find it quickly.
+static signed char pinOwner[BOARD_NR_GPIO_PINS + 1];
+
+/**
+ * the interrupt handler for every encoder pin. Keep this short - it runs on every edge.
+ */
+static void quadEdgeHandler(unsigned char pin)
+{
+	unsigned long now = micros();
+	int which = pinOwner[pin];
+	if (which < 0)
+		return;
+	QuadEncoder *enc = &encoders[which];
+
+	unsigned char newState = (digitalRead(PINS_A[which]) << 1) | digitalRead(PINS_B[which]);
+	int step = QUADRATURE_STEP[(enc->state << 2) | newState] * ORIENTATIONS[which];
+	if (newState != enc->state && step == 0)
+		enc->skipped++;
+	enc->state = newState;
+	if (step == 0)
+		return;
+
+	enc->count += step;
+
+	EncoderEdge edge = {now, step};
+	if (!EdgeRingPush(&enc->edges, &edge))
+		enc->dropped++; // the reader has fallen behind; the count is still right.
+}
+
+/**
+ * sets up the interrupts for every encoder listed in main.h. Call once, from initialize().
+ */
+void quadEncoderInit()
+{
+	for (int pin = 0; pin <= BOARD_NR_GPIO_PINS; pin++)
+		pinOwner[pin] = -1;
+
+	for (int i = 0; i < QUAD_NUM_ENCODERS; i++)
+	{
+		QuadEncoder *enc = &encoders[i];
+		pinOwner[PINS_A[i]] = i;
+		pinOwner[PINS_B[i]] = i;
+		pinMode(PINS_A[i], INPUT);
+		pinMode(PINS_B[i], INPUT);
+		enc->state = (digitalRead(PINS_A[i]) << 1) | digitalRead(PINS_B[i]);
+		ioSetInterrupt(PINS_A[i], INTERRUPT_EDGE_BOTH, quadEdgeHandler);
+		ioSetInterrupt(PINS_B[i], INTERRUPT_EDGE_BOTH, quadEdgeHandler);
+	}
+}
+
+/**
+ * how many ticks the given encoder (QUAD_FRONT_LEFT etc.) has counted since the robot started.
+ * Positive is forward. Safe to call from any task.
+ */
+int quadEncoderGet(int which)
+{
+	return encoders[which].count;
+}
+
+/**
+ * empties the given encoder's ring and works out its speed in ticks per second from the
+ * time between edges. Only ONE task may call this - it is the ring's only reader. That task
+ * is the sensor registry; everybody else should use its snapshot.
+ */
+int quadEncoderUpdateVelocity(int which)
+{
+	QuadEncoder *enc = &encoders[which];
+	bool newEdges = false;
+	int steps = 0;
+	unsigned long newestEdge = enc->lastEdgeTime;
+	EncoderEdge edge;
+	while (EdgeRingPop(&enc->edges, &edge))
+	{
+		newEdges = true;
+		steps += edge.step;
+		newestEdge = edge.time;
+	}
+
+	if (newEdges)
+	{
+		// new edges: speed = ticks / time since the last edge we had already counted.
+		unsigned long elapsed = newestEdge - enc->lastEdgeTime;
+		if (enc->haveLastEdge && elapsed > 0)
+			enc->velocity = (int)((long long)steps * 1000000 / (long long)elapsed);
+		enc->lastEdgeTime = newestEdge;
+		enc->haveLastEdge = true;
+		return enc->velocity;
+	}
+
+	// no new edges. The wheel can't be going faster than one tick per "time since the last
+	// edge", so slow our estimate down to that - and call it stopped after a while.
+	unsigned long sinceLastEdge = micros() - enc->lastEdgeTime;
+	if (!enc->haveLastEdge || sinceLastEdge > QUAD_STOPPED_US)
+		enc->velocity = 0;
+	else if (sinceLastEdge > 0)
+	{
+		int fastest = 1000000 / sinceLastEdge;
+		if (enc->velocity > fastest)
+			enc->velocity = fastest;
+		else if (enc->velocity < -fastest)
+			enc->velocity = -fastest;
+	}
+	return enc->velocity;
+}
+
+/**
+ * the speed worked out by the last quadEncoderUpdateVelocity() call, in ticks per second.
+ */
+int quadEncoderVelocity(int which)
+{
+	return encoders[which].velocity;
+}
+
+/**
+ * prints each encoder's count, speed, and any edges that were dropped or skipped.
+ */
+void quadEncoderReport(PROS_FILE *stream)
+{
+	for (int i = 0; i < QUAD_NUM_ENCODERS; i++)
+		fprintf(stream, "encoder %d: count %d, %d ticks/s, %u dropped, %u skipped\r\n", i,
+		        encoders[i].count, encoders[i].velocity, encoders[i].dropped,
+		        encoders[i].skipped);
+}
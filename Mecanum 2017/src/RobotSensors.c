@@ -0,0 +1,42 @@
+/** @file RobotSensors.c
+ * @brief Reads the sensors only this robot has, for the sensor registry
+ *
+ * The sensor registry (in the core library) reads every sensor in SENSOR_LIST on schedule,
+ * but it only knows how to read the kinds any robot might have: a port, a sonar, the
+ * battery. The gyro heading, the encoders' speeds and the IMEs come from this robot's own
+ * code, so the registry hands those to readRobotSensor().
+ */
+
+#include "main.h"
+
+/**
+ * reads one of this robot's own kinds of sensor (SENSOR_TYPE_GYRO_HEADING and so on) for the
+ * sensor registry. Pass it to sensorRegistryInit().
+ */
+bool readRobotSensor(const SensorConfig *sensor, int *value)
+{
+	switch (sensor->type)
+	{
+		case SENSOR_TYPE_GYRO_HEADING:
+			*value = gyroHeadingGet();
+			return true;
+		case SENSOR_TYPE_GYRO_RATE:
+			*value = gyroRateGet();
+			return true;
+		case SENSOR_TYPE_QUAD_ENCODER:
+			*value = quadEncoderGet(sensor->port);
+			return true;
+		case SENSOR_TYPE_QUAD_VELOCITY:
+			// the registry is the only task that empties the encoder rings.
+			*value = quadEncoderUpdateVelocity(sensor->port);
+			return true;
+		case SENSOR_TYPE_IME:
+			return imeCachedGet(sensor->port, value, NULL);
+		case SENSOR_TYPE_IME_VELOCITY:
+			return imeCachedVelocity(sensor->port, value, NULL);
+		case SENSOR_TYPE_ANALOG_SAMPLED:
+			*value = analogSampleGet(sensor->port);
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,59 @@
+/** @file RobotState.c
+ * @brief What the robot is trying to do right now, shared safely between tasks
+ *
+ * The driver's (or autonomous routine's) wishes - which way to drive, which way we're facing,
+ * whether the LED is on - used to be loose global variables. Once more than one task reads
+ * them, a reader can catch them half-updated: the new x_motion with the old y_motion, say.
+ * Here they live together in one RobotState, published through a mailbox (RingBuffer.h):
+ * the writer fills in a whole new copy and then flips a version number, and a reader that
+ * sees the version change while it was copying just copies again. Nobody ever waits on a
+ * lock, so a slow low-priority reader can't hold up the drive loop.
+ *
+ * Only ONE task may change the state at a time. That is whichever of operatorControl() or
+ * autonomous() is running - the kernel never runs both at once.
+ */
+
+#include "main.h"
+
+MAILBOX_DECLARE(StateMailbox, RobotState)
+static StateMailbox state;
+
+/**
+ * copies the latest robot state. Safe to call from any task; never waits.
+ */
+void robotStateGet(RobotState *copy)
+{
+	StateMailboxRead(&state, copy);
+}
+
+/**
+ * starts a change to the robot state: returns a copy of the current state for the writer to
+ * change as it likes. Nobody else sees the changes until robotStateCommit().
+ */
+RobotState *robotStateBegin()
+{
+	RobotState *spare = StateMailboxBegin(&state);
+	*spare = *StateMailboxCurrent(&state);
+	return spare;
+}
+
+/**
+ * publishes the changes made since robotStateBegin(), all at once.
+ */
+void robotStateCommit()
+{
+	StateMailboxBegin(&state)->timestamp = millis();
+	StateMailboxCommit(&state);
+}
+
+/**
+ * sets how the chassis should move, in one update (see manageDriveMotors()).
+ */
+void robotStateSetMotion(int x_motion, int y_motion, int angle_motion)
+{
+	RobotState *next = robotStateBegin();
+	next->x_motion = x_motion;
+	next->y_motion = y_motion;
+	next->angle_motion = angle_motion;
+	robotStateCommit();
+}
@@ -0,0 +1,54 @@
+/** @file RobotTelemetry.c
+ * @brief Fills in this robot's telemetry frames
+ *
+ * The core library's telemetry (Telemetry.c) queues frames and streams them out of UART 2,
+ * but what is in a frame is this robot's business: TelemetryFrame.h lays it out, and
+ * telemetrySample() copies this cycle's numbers into it.
+ */
+
+#include "main.h"
+
+/**
+ * fills in and queues one frame describing this cycle. Call once per cycle from the loop
+ * that drives the motors (and only that loop); extraFlags are added to the frame's flags
+ * (e.g. TELEMETRY_FLAG_AUTONOMOUS). Frames are sent at most every TELEMETRY_PERIOD ms;
+ * calls in between do nothing. Takes a few microseconds, and never waits.
+ */
+void telemetrySample(int extraFlags)
+{
+	TelemetryStamp stamp;
+	TelemetryFrame *frame = telemetryBegin(&stamp);
+	if (frame == NULL)
+		return;
+
+	RobotState state;
+	SensorSnapshot sensors;
+	robotStateGet(&state);
+	sensorSnapshotGet(&sensors);
+
+	frame->version = TELEMETRY_VERSION;
+	frame->flags = extraFlags;
+	if (fieldCentricEnabled)
+		frame->flags |= TELEMETRY_FLAG_FIELD_CENTRIC;
+	if (stamp.dropped)
+		frame->flags |= TELEMETRY_FLAG_DROPPED;
+	frame->sequence = stamp.sequence;
+	frame->time_us = stamp.time_us;
+	frame->cycle_us = stamp.cycle_us > 0xFFFF ? 0xFFFF : stamp.cycle_us;
+	frame->battery_mv = sensors.reading[SENSOR_BATTERY].value;
+	frame->heading_mdeg = odometryHeadingGet();
+	frame->turn_rate_mdps = sensors.reading[SENSOR_TURN_RATE].value;
+	frame->speed_front_left = sensors.reading[SENSOR_FRONT_LEFT_SPEED].value;
+	frame->speed_back_left = sensors.reading[SENSOR_BACK_LEFT_SPEED].value;
+	frame->speed_front_right = sensors.reading[SENSOR_FRONT_RIGHT_SPEED].value;
+	frame->speed_back_right = sensors.reading[SENSOR_BACK_RIGHT_SPEED].value;
+	frame->joy_x = state.x_motion;
+	frame->joy_y = state.y_motion;
+	frame->joy_turn = state.angle_motion;
+	frame->motor_front_left = K_getMotor(PORT_MOTOR_FRONT_LEFT);
+	frame->motor_back_left = K_getMotor(PORT_MOTOR_BACK_LEFT);
+	frame->motor_front_right = K_getMotor(PORT_MOTOR_FRONT_RIGHT);
+	frame->motor_back_right = K_getMotor(PORT_MOTOR_BACK_RIGHT);
+
+	telemetryCommit(frame);
+}
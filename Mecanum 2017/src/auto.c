@@ -31,13 +31,8 @@
 #define TRIGGER_TIME 0
 #define IS_ACTIVE 1
 
-// long-term variables..... these are about the desired motion of the chassis.
-int auto_x_motion;
-int auto_y_motion;
-int auto_angle_motion;
-
-// example for the blinking light.
-bool LED_state;
+// the desired motion of the chassis, and the blinking light, live in the shared RobotState
+// (RobotState.c) so other tasks can read them safely.
 
 // time-based variables
 long timeSinceStart;
@@ -49,26 +44,45 @@ bool actionStatus[] = {false,  // 0. ahead full
                        false,  // 2. blink
                        false,  // 3. all reverse
                        false}; // 4. unused....
-int timers[][2] = {{0,true},        //0. trigger action 0
-                   {500,true},      //1. trigger action 1
-                   {250,true},      //2. trigger action 2
-                   {1000,true},     //3. trigger action 3
-                   {1500,true},     //4. trigger action 1 (!)
-                   {1250,true}};    //5. deactivate trigger 2.
+// the trigger times are filled in from the parameter table (PARAMETER_LIST in main.h) when
+// autonomous starts, so they can be tuned from the console.
+int timers[][2] = {{0,true},        //0. trigger action 0 (AUTO_AHEAD_TIME)
+                   {0,true},        //1. trigger action 1 (AUTO_STOP_TIME)
+                   {0,true},        //2. trigger action 2 (AUTO_BLINK_TIME)
+                   {0,true},        //3. trigger action 3 (AUTO_REVERSE_TIME)
+                   {0,true},        //4. trigger action 2 again (AUTO_EXTRA_BLINK_TIME)
+                   {0,true}};       //5. deactivate trigger 2 (AUTO_BLINK_END_TIME)
 int numTimers;
 int numActions;
+int autoProfile; // the profiler's id for the autonomous loop's work
+int autoDeadline; // the autonomous loop's deadline (Deadline.c)
 
 void autonomous()
 {
+  stackMonitorRegisterCurrent("auto", TASK_DEFAULT_STACK_SIZE);
+  autoProfile = profileRegister("auto");
+  autoDeadline = deadlineRegister("auto", DEADLINE_ACTION_STOP);
+  matchLogEvent(MATCH_LOG_EVENT_AUTONOMOUS);
   startOfAuton = millis();
+  unsigned long wakeTime = startOfAuton;
 
   // calculate num items in the arrays - the memory usage of the array
   //       divided by the memory usage of each item. <-- an old "C" trick.
   numTimers = sizeof(timers)/sizeof(timers[0]);
   numActions = sizeof(actionStatus)/sizeof(actionStatus[0]);
 
+  parametersApply();
+  timers[0][TRIGGER_TIME] = paramGet(PARAM_AUTO_AHEAD_TIME);
+  timers[1][TRIGGER_TIME] = paramGet(PARAM_AUTO_STOP_TIME);
+  timers[2][TRIGGER_TIME] = paramGet(PARAM_AUTO_BLINK_TIME);
+  timers[3][TRIGGER_TIME] = paramGet(PARAM_AUTO_REVERSE_TIME);
+  timers[4][TRIGGER_TIME] = paramGet(PARAM_AUTO_EXTRA_BLINK_TIME);
+  timers[5][TRIGGER_TIME] = paramGet(PARAM_AUTO_BLINK_END_TIME);
+
   while(true)
   {
+    profileStart(autoProfile);
+    parametersApply(); // pick up any changes from the console
     timeSinceStart = millis() - startOfAuton;
 
     // loop through all the timers....
@@ -89,7 +103,7 @@ void autonomous()
            break;
            case 2:
               actionStatus[2] = true;
-              timers[2][TRIGGER_TIME] += 500; // try this again in 500 ms.
+              timers[2][TRIGGER_TIME] += paramGet(PARAM_AUTO_BLINK_PERIOD); // try this again soon.
            break;
            case 3:
               actionStatus[3] = true;
@@ -116,9 +130,7 @@ void autonomous()
          {
            case 0:  // all ahead full....
              // this is an example of writing the code in the case....
-             auto_x_motion = 127;
-             auto_y_motion = 0;
-             auto_angle_motion = 0;
+             robotStateSetMotion(127, 0, 0);
              actionStatus[0] = false;
            break;
            case 1:  // all stop.
@@ -127,9 +139,13 @@ void autonomous()
              actionStatus[1] = false;
            break;
            case 2: // toggle the LED
-             // if LED_state was true, make it false, or vice versa.
-             LED_state = ! LED_state;
+           {
+             // if the LED was on, turn it off, or vice versa.
+             RobotState *next = robotStateBegin();
+             next->ledOn = ! next->ledOn;
+             robotStateCommit();
              actionStatus[2] = false;
+           }
            break;
            case 3: // reverse
               backFull();
@@ -141,7 +157,10 @@ void autonomous()
 
 
      auton_process_motors();
-     delay(1);
+     telemetrySample(TELEMETRY_FLAG_AUTONOMOUS);
+     matchLogSample();
+     profileStop(autoProfile);
+     deadlineWait(autoDeadline, &wakeTime, AUTO_PERIOD);
      // probably unneccesary, but if we aren't in auton mode but we are here somehow,
      //       lets leave this loop!
      if (!isAutonomous())
@@ -155,9 +174,7 @@ void autonomous()
 */
 void allStop()
 {
-    auto_x_motion = 0;
-    auto_y_motion = 0;
-    auto_angle_motion = 0;
+    robotStateSetMotion(0, 0, 0);
 }
 
 /*
@@ -165,19 +182,20 @@ void allStop()
 */
 void backFull()
 {
-  auto_x_motion = 0;
-  auto_y_motion = -127;
-  auto_angle_motion = 0;
+  robotStateSetMotion(0, -127, 0);
 }
 
 /*
-*  based on the state of the global variables, update the motors.
+*  based on the shared robot state, update the motors.
 */
 void auton_process_motors()
 {
+   RobotState now;
+   robotStateGet(&now);
+
    // tell the chassis how to drive...
-   manageDriveMotors(auto_x_motion, auto_y_motion, auto_angle_motion);
+   manageDriveMotors(now.x_motion, now.y_motion, now.angle_motion);
 
    // turn on (true) or off (false) the LED on digital pin 3. (Not motor 3.)
-   digitalWrite(3,LED_state);
+   digitalWrite(3,now.ledOn);
 }
@@ -12,6 +12,15 @@
 
 #include "main.h"
 
+// the memory arenaAlloc() and the object pools (in the core library) hand out.
+K_ARENA(ARENA_SIZE);
+
+// every sensor the sensor registry reads (SENSOR_LIST in main.h).
+K_SENSORS(SENSOR_LIST);
+
+// what each telemetry frame holds (TelemetryFrame.h).
+K_TELEMETRY(TelemetryFrame);
+
 /*
  * Runs pre-initialization code. This function will be started in kernel mode one time while the
  * VEX Cortex is starting up. As the scheduler is still paused, most API functions will fail.
@@ -21,6 +30,8 @@
  * configure a UART port (usartOpen()) but cannot set up an LCD (lcdInit()).
  */
 void initializeIO() {
+  // binary telemetry (Telemetry.c, in the core library) goes out of UART 2.
+  usartInit(uart2, TELEMETRY_BAUD, SERIAL_8N1);
 }
 
 /*
@@ -37,4 +48,21 @@ void initializeIO() {
  * can be implemented in this task if desired.
  */
 void initialize() {
+  stackMonitorInit();
+  profilerInit();
+  deadlineInit();
+  parametersInit();
+  analogSamplerInit();
+
+  // uses the saved gyro calibration if there is one; if not, the robot must sit still for
+  // about a second while the gyro calibrates.
+  gyroHeadingInit();
+
+  quadEncoderInit();
+  imeCacheInit();
+  sensorRegistryInit(readRobotSensor);
+  odometryInit();
+  consoleInit();
+  telemetryInit();
+  matchLogInit();
 }
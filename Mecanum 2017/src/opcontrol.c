@@ -29,22 +29,38 @@
  *
  * This task should never exit; it should end with some kind of infinite loop, even if empty.
  */
- int x_input, y_input, angle_input;
+ SensorSnapshot sensors; // this cycle's copy of every sensor reading
  long int startTime;
  long int timeSinceStart;
+ int lcdPage = LCD_PAGE_DRIVE;
+ int driveProfile; // the profiler's id for the drive loop's work
+ int driveDeadline; // the drive loop's deadline (Deadline.c)
+ bool lcdButtonWasDown = false;
 
  void operatorControl()
  {
+	 stackMonitorRegisterCurrent("opcontrol", TASK_DEFAULT_STACK_SIZE);
+	 driveProfile = profileRegister("drive");
+	 // if the drive loop can't keep up, stop the motors rather than keep driving on an old
+	 // command.
+	 driveDeadline = deadlineRegister("drive", DEADLINE_ACTION_STOP);
+	 matchLogEvent(MATCH_LOG_EVENT_DRIVER);
 	 startTime = millis();
+	 unsigned long wakeTime = startTime;
 
 	 while (1)
 	 {
 		  timeSinceStart = millis()-startTime;
+		  profileStart(driveProfile);
+		  parametersApply(); // pick up any changes from the console
 	 		checkSensors();
       autoProcesses();
 	 		processMotors(); // convert the variables to motor commands
+		  telemetrySample(0);
+		  matchLogSample();
 	 		updateScreen();
-	 		delay(20);
+		  profileStop(driveProfile);
+		  deadlineWait(driveDeadline, &wakeTime, DRIVE_PERIOD);
 	 	}
  }
 
@@ -55,9 +71,19 @@
  void checkSensors()
  {
  	// read the joysticks - they control the motors.
- 	x_input = joystickGetAnalog(1,1);
- 	y_input = joystickGetAnalog(1,2);
- 	angle_input = joystickGetAnalog(1,4);
+ 	RobotState *next = robotStateBegin();
+ 	next->x_motion = joystickGetAnalog(1,1);
+ 	next->y_motion = joystickGetAnalog(1,2);
+ 	next->angle_motion = joystickGetAnalog(1,4);
+ 	latencyMark(LATENCY_SAMPLE);
+
+ 	// everything on the robot, as of the sensor registry's latest snapshot.
+ 	sensorSnapshotGet(&sensors);
+
+ 	// which way is the robot facing? (needed for field-centric driving.)
+ 	next->heading = odometryHeadingGet() / 1000;
+ 	robotStateCommit(); // other tasks see the joysticks and heading together, or not at all.
+ 	checkFieldCentricButtons();
  }
 
  /**
@@ -65,7 +91,39 @@
   */
  void updateScreen()
  {
- 	lcdPrint(uart1, 1, "Go Falcons!");
+ 	// when the robot can't keep up, the LCD is the first thing to go.
+ 	if (deadlineDegraded())
+ 		return;
+
+ 	// the center button flips to the next page (once per press).
+ 	bool lcdButtonIsDown = (lcdReadButtons(uart1) & LCD_BTN_CENTER) != 0;
+ 	if (lcdButtonIsDown && !lcdButtonWasDown)
+ 		lcdPage = (lcdPage + 1) % LCD_NUM_PAGES;
+ 	lcdButtonWasDown = lcdButtonIsDown;
+
+ 	if (lcdPage == LCD_PAGE_LATENCY)
+ 	{
+ 		lcdSetText(uart1, 1, "Lat min/avg/p99");
+ 		latencyShowOnLCD(2);
+ 		return;
+ 	}
+ 	if (lcdPage == LCD_PAGE_CPU)
+ 	{
+ 		profileShowOnLCD(1);
+ 		return;
+ 	}
+
+ 	RobotState now;
+ 	char text[LCD_LINE_LENGTH + 1];
+ 	robotStateGet(&now);
+ 	lcdSetText(uart1, 1, "Go Falcons!");
+ 	if (fieldCentricEnabled)
+ 	{
+ 		K_format(text, sizeof(text), K_STR("Field "), K_INT(now.heading, 4), K_STR(" deg"));
+ 		lcdSetText(uart1, 2, text);
+ 	}
+ 	else
+ 		lcdSetText(uart1, 2, "Robot centric");
  }
 
  /**
@@ -82,7 +140,15 @@
  */
  void processMotors()
  {
+  RobotState now;
+  robotStateGet(&now);
+  int x_motion = now.x_motion;
+  int y_motion = now.y_motion;
+
+  // in field-centric mode, "forward" on the joystick means "away from the driver."
+  if (fieldCentricEnabled)
+    rotateToRobotFrame(&x_motion, &y_motion, now.heading);
 
-  manageDriveMotors(x_input, y_input, angle_input);
+  manageDriveMotors(x_motion, y_motion, now.angle_motion);
 
  }
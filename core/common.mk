@@ -0,0 +1,87 @@
+# Universal C Makefile for MCU targets
+# Build settings shared by every robot project, and by the core library itself. Each
+# project's common.mk sets CORE to this directory and includes this file.
+
+MAKE_COMMAND=make
+
+# Makefile for IFI VeX Cortex Microcontroller (STM32F103VD series)
+DEVICE=VexCortex
+# Libraries to include in the link (use -L and -l) e.g. -lm, -lmyLib
+# (the core library first, as it calls into the PROS library)
+LIBRARIES=$(CORE)/bin$(PROFILE_DIR)/libkcore.a $(wildcard $(ROOT)/firmware/*.a) -lgcc -lm
+# Prefix for ARM tools (must be on the path)
+MCUPREFIX=arm-none-eabi-
+# Flags for the assembler
+MCUAFLAGS=-mthumb -mcpu=cortex-m3 -mlittle-endian
+# Flags for the compiler
+MCUCFLAGS=-mthumb -mcpu=cortex-m3 -mlittle-endian -mfloat-abi=soft
+# Flags for the linker
+MCULFLAGS=-nostartfiles -Wl,-static -Bfirmware -Wl,-u,VectorTable -Wl,-T -Xlinker firmware/cortex.ld
+# Prepares the elf file by converting it to a binary that java can write
+MCUPREPARE=$(OBJCOPY) $(OUT) -O binary $(BINDIR)/$(OUTBIN)
+# Advanced sizing flags
+SIZEFLAGS=
+# Uploads program using java
+UPLOAD=@java -jar firmware/uniflash.jar vex $(BINDIR)/$(OUTBIN)
+# Flashes program using the PROS CLI flash command
+FLASH=pros flash -f $(BINDIR)/$(OUTBIN)
+
+# Advanced options
+ASMEXT=s
+CEXT=c
+CPPEXT=cpp
+HEXT=h
+INCLUDE=-I$(ROOT)/include -I$(ROOT)/src -I$(CORE)/include
+OUTBIN=output.bin
+OUTNAME=output.elf
+OUTMAP=output.map
+
+# Each link writes a map (bin/output.map) of where every byte of flash and RAM went, and
+# tools/memory_report.py checks it against these budgets (in bytes, or with K); the build fails
+# if either is over. A project can set its own in its common.mk, before including this file.
+# RAM must leave room for the kernel heap, which holds every task's stack.
+FLASH_BUDGET?=384K
+RAM_BUDGET?=48K
+MEMORY_REPORT=python3 $(CORE)/../tools/memory_report.py
+
+# Build profile: "make PROFILE=speed" and so on. "size" (the default) is what goes on the
+# robot; the others are for comparing, with "make report". Each profile other than size builds
+# into its own bin/<profile> folder (core/bin/<profile> for the library), so switching between
+# them doesn't mix up object files.
+#   size   -Os, as small as possible
+#   speed  -O2: faster loops, bigger code
+#   lto    -Os, plus link-time optimization across files (and into the core library)
+#   debug  -Og -g, for stepping through with a debugger
+PROFILES=size speed lto debug
+PROFILE?=size
+PROFILE_CFLAGS_size=-Os -ffunction-sections -fomit-frame-pointer
+PROFILE_CFLAGS_speed=-O2 -ffunction-sections -fomit-frame-pointer
+PROFILE_CFLAGS_lto=-Os -ffunction-sections -fomit-frame-pointer -flto
+PROFILE_CFLAGS_debug=-Og -g -ffunction-sections
+# (LTO does its code generation at link time, so the linker needs the optimization flags too)
+PROFILE_LDFLAGS_lto=$(PROFILE_CFLAGS_lto)
+ifeq ($(filter $(PROFILE),$(PROFILES)),)
+$(error unknown PROFILE "$(PROFILE)"; use one of: $(PROFILES))
+endif
+ifneq ($(PROFILE),size)
+BINDIR:=$(BINDIR)/$(PROFILE)
+PROFILE_DIR=/$(PROFILE)
+endif
+
+# Flags for programs
+AFLAGS:=$(MCUAFLAGS)
+ARFLAGS:=$(MCUCFLAGS)
+CCFLAGS:=-c -Wall $(MCUCFLAGS) $(PROFILE_CFLAGS_$(PROFILE)) -fsigned-char -fsingle-precision-constant
+CFLAGS:=$(CCFLAGS) -std=gnu99 -Werror=implicit-function-declaration
+# -fstack-usage writes each function's stack frame size to bin/*.su; see tools/stack_report.py
+CFLAGS+=-fstack-usage
+CPPFLAGS:=$(CCFLAGS) -fno-exceptions -fno-rtti -felide-constructors
+LDFLAGS:=-Wall $(MCUCFLAGS) $(MCULFLAGS) $(PROFILE_LDFLAGS_$(PROFILE)) -Wl,--gc-sections -Wl,-Map,$(BINDIR)/$(OUTMAP)
+
+# Tools used in program
+# (gcc-ar, not plain ar, so the library's index covers LTO objects too)
+AR:=$(MCUPREFIX)gcc-ar
+AS:=$(MCUPREFIX)as
+CC:=$(MCUPREFIX)gcc
+CPPCC:=$(MCUPREFIX)g++
+OBJCOPY:=$(MCUPREFIX)objcopy
@@ -0,0 +1,108 @@
+/** @file Host.h
+ * @brief What the parts of the PC stand-in for PROS share
+ *
+ * core/host is built into every "make host" program (see host.mk). It gives the robot code
+ * the same API the PROS library does on the Cortex:
+ *  - HostTasks.c: tasks are POSIX threads; delays, semaphores and mutexes
+ *  - HostIO.c: the serial console is stdin/stdout, flash files are files in a folder, and
+ *    the LCD is two lines of text
+ *  - Simulator.c: motors, sensors, joystick and competition switch, on a simulated robot
+ *  - HostMain.c: starts it all up like the kernel does, and runs a match
+ *
+ * Priorities are not kept, except that TASK_PRIORITY_LOWEST tasks only get the CPU when
+ * nothing else wants it (where the PC supports that). Every task really runs at the same
+ * time as the others, on as many cores as the PC has.
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include "ProsHost.h"
+#include <kcore.h>
+
+// the shim needs the PC's own stdio too; the PROS versions are still there, as pros_fopen()
+// and so on.
+#undef fclose
+#undef feof
+#undef fflush
+#undef fgetc
+#undef fgets
+#undef fopen
+#undef fprintf
+#undef fputc
+#undef fputs
+#undef fread
+#undef fseek
+#undef ftell
+#undef fwrite
+#undef wait
+#undef stdout
+#undef stdin
+#undef FILE
+#include <stdio.h>
+
+#include "Simulator.h"
+
+// the PROS stream that stdout and stdin both stand for (API.h)
+#define PROS_CONSOLE ((PROS_FILE *)3)
+
+// -------------------------  Methods in HostTasks.c --------------------------
+/**
+ * starts the clock that millis() and micros() count from. Call before anything else.
+ */
+void hostTasksInit();
+
+/**
+ * waits until the given task has finished.
+ */
+void hostTaskJoin(TaskHandle task);
+
+/**
+ * sleeps the calling thread for the given number of microseconds. Unlike delay(), this
+ * doesn't care whether it is called from a task.
+ */
+void hostSleep(unsigned long long us);
+
+// -------------------------  Methods in HostIO.c --------------------------
+/**
+ * sets up the files the PROS streams go to: flash files live in the folder flashDir (which is
+ * made if need be), and whatever is written to UART 2 goes to the file uart2Path, if not NULL.
+ * If echoLcd is true, every change to the LCD is printed on stderr. Returns false if something
+ * couldn't be opened.
+ */
+bool hostIOInit(const char *flashDir, const char *uart2Path, bool echoLcd);
+
+/**
+ * prints what the LCD is showing.
+ */
+void hostLcdReport(FILE *stream);
+
+// -------------------------  Methods in Simulator.c --------------------------
+/**
+ * reads the driver's joystick moves from the file at path (see Simulator.c for the format),
+ * or uses the built-in ones if path is NULL. Returns false if the file can't be read.
+ */
+bool simLoadJoystick(const char *path);
+
+/**
+ * starts the simulation running, in a thread of its own.
+ */
+void simStart();
+
+/**
+ * sets the competition switch: enabled or disabled, autonomous or driver control. The joystick
+ * script starts again from the top each time driver control starts.
+ */
+void simSetMode(bool enabled, bool autonomous);
+
+/**
+ * the LCD's buttons that are held down, as lcdReadButtons() gives them.
+ */
+unsigned int simLcdButtons();
+
+/**
+ * prints where the simulated robot is, and what each motor is doing.
+ */
+void simReport(FILE *stream);
+
+#endif
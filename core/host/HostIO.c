@@ -0,0 +1,347 @@
+/** @file HostIO.c
+ * @brief The PROS streams for the PC build: console, UARTs, flash files and the LCD
+ *
+ * PROS hands out a stream as a small number dressed up as a pointer: 1 and 2 are the UARTs,
+ * 3 is the console (stdout and stdin), and files get the numbers after that. Here:
+ *  - the console is the PC's stdin and stdout, so the serial console works from a terminal
+ *  - UART 1 is where the LCD is plugged in; anything else written to it is dropped
+ *  - UART 2 goes to a file if one was given (--uart2), e.g. for tools/telemetry.py to read
+ *  - flash files are files in a folder, so saved parameters and logs last from one run to the
+ *    next, as they would on the robot. The same rules apply: names are cut to 8 characters,
+ *    "r" or "w" only, and at most HOST_MAX_FILES open at once.
+ */
+
+#include "Host.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define PROS_UART1 1
+#define PROS_UART2 2
+#define PROS_CONSOLE_ID 3
+#define FIRST_FILE 4
+
+// as on the Cortex: how many files can be open at once, and how long a name can be.
+#define HOST_MAX_FILES 4
+#define HOST_FILE_NAME_LENGTH 8
+
+#define LCD_LINES 2
+
+/**
+ * one open flash file.
+ */
+typedef struct {
+	FILE *file;
+	bool writing;
+} HostFile;
+
+static HostFile files[HOST_MAX_FILES];
+static pthread_mutex_t filesLock = PTHREAD_MUTEX_INITIALIZER;
+static char flashFolder[512];
+static FILE *uart2File = NULL;
+
+static char lcdText[LCD_LINES][LCD_LINE_LENGTH + 1];
+static pthread_mutex_t lcdLock = PTHREAD_MUTEX_INITIALIZER;
+static bool lcdEcho = false;
+
+/**
+ * sets up the files the PROS streams go to: flash files live in the folder flashDir (which is
+ * made if need be), and whatever is written to UART 2 goes to the file uart2Path, if not NULL.
+ * If echoLcd is true, every change to the LCD is printed on stderr. Returns false if something
+ * couldn't be opened.
+ */
+bool hostIOInit(const char *flashDir, const char *uart2Path, bool echoLcd)
+{
+	snprintf(flashFolder, sizeof(flashFolder), "%s", flashDir);
+	mkdir(flashFolder, 0777);
+	struct stat folder;
+	if (stat(flashFolder, &folder) != 0 || !S_ISDIR(folder.st_mode))
+	{
+		fprintf(stderr, "can't use %s for flash files\n", flashFolder);
+		return false;
+	}
+	if (uart2Path != NULL)
+	{
+		uart2File = fopen(uart2Path, "wb");
+		if (uart2File == NULL)
+		{
+			fprintf(stderr, "can't write UART 2 to %s\n", uart2Path);
+			return false;
+		}
+	}
+	lcdEcho = echoLcd;
+	return true;
+}
+
+/**
+ * the stream number behind a PROS_FILE.
+ */
+static int streamId(PROS_FILE *stream)
+{
+	return (int)(intptr_t)stream;
+}
+
+/**
+ * the flash file behind a stream, or NULL if it isn't an open one.
+ */
+static HostFile *fileOf(PROS_FILE *stream)
+{
+	int slot = streamId(stream) - FIRST_FILE;
+	if (slot < 0 || slot >= HOST_MAX_FILES || files[slot].file == NULL)
+		return NULL;
+	return &files[slot];
+}
+
+/**
+ * the PC file to write a stream to, or NULL to drop what is written.
+ */
+static FILE *writeTarget(PROS_FILE *stream)
+{
+	switch (streamId(stream))
+	{
+	case PROS_CONSOLE_ID:
+		return stdout;
+	case PROS_UART2:
+		return uart2File;
+	case PROS_UART1:
+		return NULL; // the LCD's port; use lcdSetText()
+	}
+	HostFile *file = fileOf(stream);
+	return file != NULL && file->writing ? file->file : NULL;
+}
+
+/**
+ * the PC file to read a stream from, or NULL if there is nothing to read.
+ */
+static FILE *readSource(PROS_FILE *stream)
+{
+	if (streamId(stream) == PROS_CONSOLE_ID)
+		return stdin;
+	HostFile *file = fileOf(stream);
+	return file != NULL && !file->writing ? file->file : NULL;
+}
+
+PROS_FILE *pros_fopen(const char *file, const char *mode)
+{
+	bool writing = mode[0] == 'w';
+	if ((mode[0] != 'r' && !writing) || mode[1] != '\0')
+		return NULL;
+	char path[sizeof(flashFolder) + HOST_FILE_NAME_LENGTH + 2];
+	snprintf(path, sizeof(path), "%s/%.*s", flashFolder, HOST_FILE_NAME_LENGTH, file);
+
+	pthread_mutex_lock(&filesLock);
+	PROS_FILE *stream = NULL;
+	for (int slot = 0; slot < HOST_MAX_FILES; slot++)
+	{
+		if (files[slot].file != NULL)
+			continue;
+		files[slot].file = fopen(path, writing ? "wb" : "rb");
+		files[slot].writing = writing;
+		if (files[slot].file != NULL)
+			stream = (PROS_FILE *)(intptr_t)(FIRST_FILE + slot);
+		break;
+	}
+	pthread_mutex_unlock(&filesLock);
+	return stream;
+}
+
+void pros_fclose(PROS_FILE *stream)
+{
+	pthread_mutex_lock(&filesLock);
+	HostFile *file = fileOf(stream);
+	if (file != NULL)
+	{
+		fclose(file->file);
+		file->file = NULL;
+	}
+	pthread_mutex_unlock(&filesLock);
+}
+
+int fdelete(const char *file)
+{
+	char path[sizeof(flashFolder) + HOST_FILE_NAME_LENGTH + 2];
+	snprintf(path, sizeof(path), "%s/%.*s", flashFolder, HOST_FILE_NAME_LENGTH, file);
+	return remove(path) == 0 ? 0 : 1;
+}
+
+/**
+ * for a file: the bytes left to read. The console can't tell without blocking, so 0.
+ */
+int fcount(PROS_FILE *stream)
+{
+	HostFile *file = fileOf(stream);
+	if (file == NULL || file->writing)
+		return 0;
+	long here = ftell(file->file);
+	fseek(file->file, 0, SEEK_END);
+	long end = ftell(file->file);
+	fseek(file->file, here, SEEK_SET);
+	return (int)(end - here);
+}
+
+int pros_feof(PROS_FILE *stream)
+{
+	FILE *source = readSource(stream);
+	if (source == NULL)
+		return 1;
+	int c = getc(source);
+	if (c == EOF)
+		return 1;
+	ungetc(c, source);
+	return 0;
+}
+
+int pros_fflush(PROS_FILE *stream)
+{
+	FILE *target = writeTarget(stream);
+	if (target != NULL)
+		return fflush(target);
+	return 0;
+}
+
+int pros_fgetc(PROS_FILE *stream)
+{
+	FILE *source = readSource(stream);
+	return source != NULL ? getc(source) : -1;
+}
+
+char *pros_fgets(char *str, int num, PROS_FILE *stream)
+{
+	FILE *source = readSource(stream);
+	return source != NULL ? fgets(str, num, source) : NULL;
+}
+
+size_t pros_fread(void *ptr, size_t size, size_t count, PROS_FILE *stream)
+{
+	FILE *source = readSource(stream);
+	return source != NULL ? fread(ptr, size, count, source) : 0;
+}
+
+int pros_fseek(PROS_FILE *stream, long int offset, int origin)
+{
+	HostFile *file = fileOf(stream);
+	return file != NULL ? fseek(file->file, offset, origin) : -1;
+}
+
+long int pros_ftell(PROS_FILE *stream)
+{
+	HostFile *file = fileOf(stream);
+	return file != NULL ? ftell(file->file) : -1;
+}
+
+size_t pros_fwrite(const void *ptr, size_t size, size_t count, PROS_FILE *stream)
+{
+	FILE *target = writeTarget(stream);
+	if (target == NULL)
+		return streamId(stream) < FIRST_FILE ? count : 0; // a port takes anything
+	return fwrite(ptr, size, count, target);
+}
+
+int pros_fputc(int value, PROS_FILE *stream)
+{
+	unsigned char c = (unsigned char)value;
+	return pros_fwrite(&c, 1, 1, stream) == 1 ? c : EOF;
+}
+
+int pros_fputs(const char *string, PROS_FILE *stream)
+{
+	size_t length = strlen(string);
+	if (pros_fwrite(string, 1, length, stream) != length)
+		return EOF;
+	return pros_fputc('\n', stream) == EOF ? EOF : 1;
+}
+
+void fprint(const char *string, PROS_FILE *stream)
+{
+	pros_fwrite(string, 1, strlen(string), stream);
+}
+
+void print(const char *string)
+{
+	fprint(string, PROS_CONSOLE);
+}
+
+int pros_fprintf(PROS_FILE *stream, const char *formatString, ...)
+{
+	char text[256];
+	va_list args;
+	va_start(args, formatString);
+	int length = vsnprintf(text, sizeof(text), formatString, args);
+	va_end(args);
+	if (length < 0)
+		return length;
+	if ((size_t)length >= sizeof(text))
+		length = sizeof(text) - 1;
+	pros_fwrite(text, 1, length, stream);
+	return length;
+}
+
+/**
+ * the serial ports need no setting up on a PC.
+ */
+void usartInit(PROS_FILE *usart, unsigned int baud, unsigned int flags)
+{
+}
+
+void usartShutdown(PROS_FILE *usart)
+{
+}
+
+void lcdInit(PROS_FILE *lcdPort)
+{
+}
+
+void lcdShutdown(PROS_FILE *lcdPort)
+{
+}
+
+void lcdSetBacklight(PROS_FILE *lcdPort, bool backlight)
+{
+}
+
+void lcdSetText(PROS_FILE *lcdPort, unsigned char line, const char *buffer)
+{
+	if (line < 1 || line > LCD_LINES)
+		return;
+	pthread_mutex_lock(&lcdLock);
+	char *text = lcdText[line - 1];
+	bool changed = strncmp(text, buffer, LCD_LINE_LENGTH) != 0;
+	snprintf(text, LCD_LINE_LENGTH + 1, "%s", buffer);
+	if (changed && lcdEcho)
+		fprintf(stderr, "[%7lu] LCD %d: %s\n", millis(), line, text);
+	pthread_mutex_unlock(&lcdLock);
+}
+
+void lcdClear(PROS_FILE *lcdPort)
+{
+	for (unsigned char line = 1; line <= LCD_LINES; line++)
+		lcdSetText(lcdPort, line, "");
+}
+
+void lcdPrint(PROS_FILE *lcdPort, unsigned char line, const char *formatString, ...)
+{
+	char text[LCD_LINE_LENGTH + 1];
+	va_list args;
+	va_start(args, formatString);
+	vsnprintf(text, sizeof(text), formatString, args);
+	va_end(args);
+	lcdSetText(lcdPort, line, text);
+}
+
+unsigned int lcdReadButtons(PROS_FILE *lcdPort)
+{
+	return simLcdButtons();
+}
+
+/**
+ * prints what the LCD is showing.
+ */
+void hostLcdReport(FILE *stream)
+{
+	pthread_mutex_lock(&lcdLock);
+	for (int line = 0; line < LCD_LINES; line++)
+		fprintf(stream, "LCD %d: %s\n", line + 1, lcdText[line]);
+	pthread_mutex_unlock(&lcdLock);
+}
@@ -0,0 +1,170 @@
+/** @file HostMain.c
+ * @brief Starts the robot code on a PC the way the PROS kernel does on the Cortex, then plays
+ * a match
+ *
+ * initializeIO() runs first, then initialize() in a task of its own. Once that has finished,
+ * the robot is disabled for DISABLED_TIME, then runs autonomous() for --autonomous seconds,
+ * is disabled again, runs operatorControl() for --driver seconds and is disabled once more -
+ * so code that waits for the robot to be disabled (the match log, "param save") gets its
+ * turn. autonomous() and operatorControl() are stopped when their time is up, as on the
+ * field. At the end, where the robot got to and what the LCD says are printed on stderr.
+ * Ctrl-C cuts short whichever period is running.
+ */
+
+#include "Host.h"
+#include <getopt.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+// how long the robot is disabled before, between and after the periods of the match (ms)
+#define DISABLED_TIME 1000
+
+// the project's own start-up code (main.h)
+void initializeIO();
+void initialize();
+void autonomous();
+void operatorControl();
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterrupt(int signal)
+{
+	interrupted = 1;
+}
+
+static void initializeTask(void *ignore)
+{
+	initialize();
+}
+
+static void autonomousTask(void *ignore)
+{
+	autonomous();
+}
+
+static void operatorControlTask(void *ignore)
+{
+	operatorControl();
+}
+
+/**
+ * waits for the given number of seconds (for ever if 0), or until Ctrl-C.
+ */
+static void waitFor(double seconds)
+{
+	unsigned long until = millis() + (unsigned long)(seconds * 1000);
+	while (!interrupted && (seconds <= 0 || millis() < until))
+		hostSleep(10000);
+}
+
+/**
+ * runs one period of the match: enables the robot, starts code as the kernel would start
+ * autonomous() or operatorControl(), and stops it again after the given number of seconds.
+ */
+static void runPeriod(bool isAutonomous, TaskCode code, double seconds)
+{
+	simSetMode(true, isAutonomous);
+	TaskHandle task = taskCreate(code, TASK_DEFAULT_STACK_SIZE, NULL, TASK_PRIORITY_DEFAULT);
+	waitFor(seconds);
+	taskDelete(task);
+	simSetMode(false, false);
+	motorStopAll();
+	hostSleep(DISABLED_TIME * 1000);
+}
+
+static void usage(FILE *stream, const char *program)
+{
+	fprintf(stream,
+	        "usage: %s [options]\n"
+	        "Runs the robot code against a simulated robot: autonomous, then driver control.\n"
+	        "  -a, --autonomous SECONDS  how long autonomous lasts (default 0: skip it)\n"
+	        "  -d, --driver SECONDS      how long driver control lasts (default 10; 0 runs\n"
+	        "                            until Ctrl-C)\n"
+	        "  -j, --joystick FILE       the driver's joystick moves (see core/host/Simulator.c)\n"
+	        "  -f, --flash FOLDER        where flash files are kept (default: flash, next to\n"
+	        "                            this program)\n"
+	        "  -u, --uart2 FILE          save what is sent out of UART 2 (telemetry) to FILE\n"
+	        "  -l, --lcd                 print the LCD whenever it changes\n"
+	        "  -h, --help                show this\n"
+	        "The serial console is this terminal.\n",
+	        program);
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option OPTIONS[] = {
+		{"autonomous", required_argument, NULL, 'a'},
+		{"driver", required_argument, NULL, 'd'},
+		{"joystick", required_argument, NULL, 'j'},
+		{"flash", required_argument, NULL, 'f'},
+		{"uart2", required_argument, NULL, 'u'},
+		{"lcd", no_argument, NULL, 'l'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}};
+	double autonomousSeconds = 0;
+	double driverSeconds = 10;
+	const char *joystick = NULL;
+	const char *uart2Path = NULL;
+	bool echoLcd = false;
+
+	// flash files go next to the program unless told otherwise
+	char flash[512];
+	const char *slash = strrchr(argv[0], '/');
+	snprintf(flash, sizeof(flash), "%.*sflash", slash != NULL ? (int)(slash - argv[0] + 1) : 0,
+	         argv[0]);
+
+	int option;
+	while ((option = getopt_long(argc, argv, "a:d:j:f:u:lh", OPTIONS, NULL)) != -1)
+	{
+		switch (option)
+		{
+		case 'a':
+			autonomousSeconds = atof(optarg);
+			break;
+		case 'd':
+			driverSeconds = atof(optarg);
+			break;
+		case 'j':
+			joystick = optarg;
+			break;
+		case 'f':
+			snprintf(flash, sizeof(flash), "%s", optarg);
+			break;
+		case 'u':
+			uart2Path = optarg;
+			break;
+		case 'l':
+			echoLcd = true;
+			break;
+		case 'h':
+			usage(stdout, argv[0]);
+			return 0;
+		default:
+			usage(stderr, argv[0]);
+			return 2;
+		}
+	}
+
+	hostTasksInit();
+	if (!hostIOInit(flash, uart2Path, echoLcd) || !simLoadJoystick(joystick))
+		return 1;
+	signal(SIGINT, onInterrupt);
+	simStart();
+
+	initializeIO();
+	hostTaskJoin(taskCreate(initializeTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                        TASK_PRIORITY_DEFAULT));
+	hostSleep(DISABLED_TIME * 1000);
+
+	if (autonomousSeconds > 0 && !interrupted)
+		runPeriod(true, autonomousTask, autonomousSeconds);
+	interrupted = 0;
+	runPeriod(false, operatorControlTask, driverSeconds);
+
+	fflush(stdout);
+	fprintf(stderr, "after %.1f s:\n", millis() / 1000.0);
+	simReport(stderr);
+	hostLcdReport(stderr);
+	exit(0);
+}
@@ -0,0 +1,432 @@
+/** @file HostTasks.c
+ * @brief Tasks, time, semaphores and mutexes for the PC build, on POSIX threads
+ *
+ * Each task is a thread. Only TASK_PRIORITY_LOWEST means anything to the PC: those threads
+ * are given SCHED_IDLE (on Linux), so they only get time no other thread wants, as on the
+ * Cortex. taskSuspend() and taskDelete() on
+ * another task take effect when that task next waits (in delay() and so on), since a thread
+ * can't safely be stopped anywhere else.
+ */
+
+#define _GNU_SOURCE
+#include "Host.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * one task.
+ */
+typedef struct {
+	pthread_t thread;
+	TaskCode code;
+	void *parameters;
+	volatile unsigned int state;  // TASK_RUNNING and so on
+	unsigned int priority;        // only kept for taskPriorityGet()
+	volatile bool suspended;
+} HostTask;
+
+/**
+ * a semaphore or mutex: count is 1 when it can be taken.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t given;
+	unsigned int count;
+} HostSemaphore;
+
+static struct timespec startTime;
+static volatile unsigned int numTasks = 0;
+
+// which task this thread is (NULL for threads the shim started itself)
+static __thread HostTask *currentTask = NULL;
+
+// taskSuspend() and taskResume() wait and signal here.
+static pthread_mutex_t suspendLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t resumed = PTHREAD_COND_INITIALIZER;
+
+/**
+ * starts the clock that millis() and micros() count from. Call before anything else.
+ */
+void hostTasksInit()
+{
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+}
+
+/**
+ * microseconds since hostTasksInit().
+ */
+static unsigned long long elapsedMicros()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)(now.tv_sec - startTime.tv_sec) * 1000000ULL +
+	       (now.tv_nsec - startTime.tv_nsec) / 1000;
+}
+
+unsigned long micros()
+{
+	return (unsigned long)elapsedMicros();
+}
+
+unsigned long millis()
+{
+	return (unsigned long)(elapsedMicros() / 1000);
+}
+
+/**
+ * sleeps the calling thread for the given number of microseconds. Unlike delay(), this
+ * doesn't care whether it is called from a task.
+ */
+void hostSleep(unsigned long long us)
+{
+	struct timespec left = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000};
+	while (nanosleep(&left, &left) != 0 && errno == EINTR)
+		;
+}
+
+/**
+ * if the calling task has been suspended, waits for taskResume(). (It can't be cancelled while
+ * it waits, or it would be holding suspendLock; taskDelete() resumes it first.)
+ */
+static void checkSuspended()
+{
+	HostTask *task = currentTask;
+	if (task == NULL || !task->suspended)
+		return;
+	int cancelState;
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+	pthread_mutex_lock(&suspendLock);
+	task->state = TASK_SUSPENDED;
+	while (task->suspended)
+		pthread_cond_wait(&resumed, &suspendLock);
+	task->state = TASK_RUNNING;
+	pthread_mutex_unlock(&suspendLock);
+	pthread_setcancelstate(cancelState, NULL);
+	pthread_testcancel();
+}
+
+/**
+ * sleeps the calling task until micros() reaches wakeTime (straight away if it already has).
+ * This is where another task's taskDelete() or taskSuspend() catches up with it.
+ */
+static void sleepUntil(unsigned long long wakeTime)
+{
+	HostTask *task = currentTask;
+	unsigned long long now = elapsedMicros();
+	if (task != NULL)
+		task->state = TASK_SLEEPING;
+	pthread_testcancel();
+	if (wakeTime > now)
+		hostSleep(wakeTime - now);
+	if (task != NULL)
+		task->state = TASK_RUNNING;
+	checkSuspended();
+}
+
+void delay(const unsigned long time)
+{
+	sleepUntil(elapsedMicros() + (unsigned long long)time * 1000);
+}
+
+void taskDelay(const unsigned long msToDelay)
+{
+	delay(msToDelay);
+}
+
+void pros_wait(const unsigned long time)
+{
+	delay(time);
+}
+
+/**
+ * like the Cortex, this waits by watching the clock rather than letting other tasks run.
+ */
+void delayMicroseconds(const unsigned long us)
+{
+	unsigned long long until = elapsedMicros() + us;
+	while (elapsedMicros() < until)
+		;
+}
+
+void taskDelayUntil(unsigned long *previousWakeTime, const unsigned long cycleTime)
+{
+	*previousWakeTime += cycleTime;
+	sleepUntil((unsigned long long)*previousWakeTime * 1000);
+}
+
+void waitUntil(unsigned long *previousWakeTime, const unsigned long time)
+{
+	taskDelayUntil(previousWakeTime, time);
+}
+
+/**
+ * marks the task dead as its thread ends, however it ends.
+ */
+static void taskEnded(void *parameters)
+{
+	HostTask *task = parameters;
+	task->state = TASK_DEAD;
+	__sync_fetch_and_sub(&numTasks, 1);
+}
+
+/**
+ * the first thing every task's thread runs.
+ */
+static void *taskThread(void *parameters)
+{
+	HostTask *task = parameters;
+	currentTask = task;
+	pthread_cleanup_push(taskEnded, task);
+	checkSuspended();
+	task->code(task->parameters);
+	pthread_cleanup_pop(1);
+	return NULL;
+}
+
+/**
+ * the stack depth is ignored: threads get the PC's default, which is far more than any task
+ * is given on the Cortex (and PC code needs more anyway).
+ */
+TaskHandle taskCreate(TaskCode taskCode, const unsigned int stackDepth, void *parameters,
+                      const unsigned int priority)
+{
+	HostTask *task = calloc(1, sizeof(HostTask));
+	if (task == NULL)
+		return NULL;
+	task->code = taskCode;
+	task->parameters = parameters;
+	task->priority = priority;
+	task->state = TASK_RUNNABLE;
+	__sync_fetch_and_add(&numTasks, 1);
+	if (pthread_create(&task->thread, NULL, taskThread, task) != 0)
+	{
+		__sync_fetch_and_sub(&numTasks, 1);
+		free(task);
+		return NULL;
+	}
+	pthread_detach(task->thread);
+#ifdef SCHED_IDLE
+	if (priority == TASK_PRIORITY_LOWEST)
+	{
+		struct sched_param idle = {0};
+		pthread_setschedparam(task->thread, SCHED_IDLE, &idle);
+	}
+#endif
+	return task;
+}
+
+/**
+ * a loop for taskRunLoop(): calls its function every increment ms.
+ */
+typedef struct {
+	void (*fn)(void);
+	unsigned long increment;
+} RunLoop;
+
+static void runLoopTask(void *parameters)
+{
+	RunLoop *loop = parameters;
+	unsigned long wakeTime = millis();
+	while (true)
+	{
+		loop->fn();
+		taskDelayUntil(&wakeTime, loop->increment);
+	}
+}
+
+TaskHandle taskRunLoop(void (*fn)(void), const unsigned long increment)
+{
+	RunLoop *loop = malloc(sizeof(RunLoop));
+	if (loop == NULL)
+		return NULL;
+	loop->fn = fn;
+	loop->increment = increment;
+	return taskCreate(runLoopTask, TASK_DEFAULT_STACK_SIZE, loop, TASK_PRIORITY_DEFAULT);
+}
+
+/**
+ * waits until the given task has finished.
+ */
+void hostTaskJoin(TaskHandle task)
+{
+	HostTask *hostTask = task;
+	while (hostTask->state != TASK_DEAD)
+		hostSleep(1000);
+}
+
+void taskDelete(TaskHandle taskToDelete)
+{
+	HostTask *task = taskToDelete;
+	if (task == NULL || task == currentTask)
+		pthread_exit(NULL);
+	if (task->state != TASK_DEAD)
+	{
+		pthread_cancel(task->thread);
+		taskResume(task); // if it is suspended, it has to wake up to see it was cancelled
+	}
+}
+
+unsigned int taskGetCount()
+{
+	return numTasks;
+}
+
+unsigned int taskGetState(TaskHandle task)
+{
+	HostTask *hostTask = task;
+	if (hostTask == NULL || hostTask == currentTask)
+		return TASK_RUNNING;
+	return hostTask->state;
+}
+
+unsigned int taskPriorityGet(const TaskHandle task)
+{
+	HostTask *hostTask = task != NULL ? task : currentTask;
+	return hostTask != NULL ? hostTask->priority : TASK_PRIORITY_DEFAULT;
+}
+
+void taskPrioritySet(TaskHandle task, const unsigned int newPriority)
+{
+	HostTask *hostTask = task != NULL ? task : currentTask;
+	if (hostTask != NULL)
+		hostTask->priority = newPriority;
+}
+
+void taskSuspend(TaskHandle taskToSuspend)
+{
+	HostTask *task = taskToSuspend != NULL ? taskToSuspend : currentTask;
+	if (task == NULL)
+		return;
+	task->suspended = true;
+	if (task == currentTask)
+		checkSuspended();
+}
+
+void taskResume(TaskHandle taskToResume)
+{
+	HostTask *task = taskToResume;
+	pthread_mutex_lock(&suspendLock);
+	task->suspended = false;
+	pthread_cond_broadcast(&resumed);
+	pthread_mutex_unlock(&suspendLock);
+}
+
+/**
+ * a new semaphore or mutex, holding count (0 or 1).
+ */
+static HostSemaphore *semaphoreNew(unsigned int count)
+{
+	HostSemaphore *semaphore = malloc(sizeof(HostSemaphore));
+	if (semaphore == NULL)
+		return NULL;
+	pthread_mutex_init(&semaphore->lock, NULL);
+	pthread_cond_init(&semaphore->given, NULL);
+	semaphore->count = count;
+	return semaphore;
+}
+
+/**
+ * gives a semaphore or mutex back. Returns false if it hadn't been taken.
+ */
+static bool semaphoreRelease(HostSemaphore *semaphore)
+{
+	pthread_mutex_lock(&semaphore->lock);
+	bool wasTaken = semaphore->count == 0;
+	semaphore->count = 1;
+	pthread_cond_signal(&semaphore->given);
+	pthread_mutex_unlock(&semaphore->lock);
+	return wasTaken;
+}
+
+/**
+ * takes a semaphore or mutex, waiting up to blockTime ms for it (for ever if blockTime is
+ * -1, as API.h has it). Returns false if it wasn't given in time.
+ */
+static bool semaphoreAcquire(HostSemaphore *semaphore, unsigned long blockTime)
+{
+	struct timespec until;
+	clock_gettime(CLOCK_REALTIME, &until);
+	until.tv_sec += blockTime / 1000;
+	until.tv_nsec += (long)(blockTime % 1000) * 1000000;
+	if (until.tv_nsec >= 1000000000)
+	{
+		until.tv_sec++;
+		until.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&semaphore->lock);
+	bool taken = true;
+	while (semaphore->count == 0 && taken)
+	{
+		if (blockTime == (unsigned long)-1)
+			pthread_cond_wait(&semaphore->given, &semaphore->lock);
+		else
+			taken = pthread_cond_timedwait(&semaphore->given, &semaphore->lock, &until) == 0 ||
+			        semaphore->count != 0;
+	}
+	if (taken)
+		semaphore->count = 0;
+	pthread_mutex_unlock(&semaphore->lock);
+	return taken;
+}
+
+static void semaphoreFree(HostSemaphore *semaphore)
+{
+	pthread_mutex_destroy(&semaphore->lock);
+	pthread_cond_destroy(&semaphore->given);
+	free(semaphore);
+}
+
+Semaphore semaphoreCreate()
+{
+	return semaphoreNew(1);
+}
+
+bool semaphoreGive(Semaphore semaphore)
+{
+	return semaphoreRelease(semaphore);
+}
+
+bool semaphoreTake(Semaphore semaphore, const unsigned long blockTime)
+{
+	return semaphoreAcquire(semaphore, blockTime);
+}
+
+void semaphoreDelete(Semaphore semaphore)
+{
+	semaphoreFree(semaphore);
+}
+
+Mutex mutexCreate()
+{
+	return semaphoreNew(1);
+}
+
+bool mutexGive(Mutex mutex)
+{
+	return semaphoreRelease(mutex);
+}
+
+bool mutexTake(Mutex mutex, const unsigned long blockTime)
+{
+	return semaphoreAcquire(mutex, blockTime);
+}
+
+void mutexDelete(Mutex mutex)
+{
+	semaphoreFree(mutex);
+}
+
+/**
+ * nothing to do: there is no watchdog, and no field to be in standalone mode from.
+ */
+void watchdogInit()
+{
+}
+
+void standaloneModeEnable()
+{
+}
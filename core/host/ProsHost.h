@@ -0,0 +1,32 @@
+/** @file ProsHost.h
+ * @brief Read before anything else when robot code is built for a PC ("make host")
+ *
+ * host.mk gives this to the compiler with -include, so it comes before API.h. Some PROS
+ * functions have the same names as the PC's C library ones but take a PROS_FILE (an int)
+ * instead of a FILE - fopen(), fprintf() and the rest. Renaming them here means the robot
+ * code calls the shim's versions (HostIO.c) and the C library keeps its own. The rest of the
+ * PROS API has names of its own, and the shim provides it as it is.
+ */
+
+#ifndef PROS_HOST_H_
+#define PROS_HOST_H_
+
+// for kcore.h and anything else that must be different on a PC
+#define K_HOST 1
+
+#define fclose pros_fclose
+#define feof pros_feof
+#define fflush pros_fflush
+#define fgetc pros_fgetc
+#define fgets pros_fgets
+#define fopen pros_fopen
+#define fprintf pros_fprintf
+#define fputc pros_fputc
+#define fputs pros_fputs
+#define fread pros_fread
+#define fseek pros_fseek
+#define ftell pros_ftell
+#define fwrite pros_fwrite
+#define wait pros_wait
+
+#endif
@@ -0,0 +1,712 @@
+/** @file Simulator.c
+ * @brief A simulated Cortex and robot for the PC build: motors, sensors, joystick and switch
+ *
+ * A thread moves the simulation on every SIM_PERIOD_US. Each motor's speed follows its power
+ * (reaching SIM_MOTOR_FREE_RPM at full power, with a lag of SIM_MOTOR_TIME_CONSTANT), and the
+ * drive wheels described in simRobot (Simulator.h) move the robot. The sensors read from
+ * that: quadrature encoders get real edges on their pins, with their interrupt handlers
+ * called just as the Cortex would; IMEs count their motor's turns; the gyro's analog port
+ * reads SIM_GYRO_BIAS plus the turn rate (and a little noise); the ultrasonic sees the wall
+ * in front of where the robot started. Anything not in simRobot reads as unplugged. As on the
+ * Cortex, the motors stop whenever the robot is disabled.
+ *
+ * The driver is a script of joystick moves, one line for each change:
+ *
+ *   # time (ms into driver control), axes 1-4, then any buttons held down
+ *   0     0   0  0   0
+ *   1000  0  80  0   0
+ *   3000  0   0  0  60  8U
+ *   4000  0   0  0   0  LCD-C
+ *
+ * Buttons are a group and a direction (5U, 5D, 6U, 6D, 7L, 8R and so on), or LCD-L, LCD-C or
+ * LCD-R for the LCD's buttons. Each line holds until the next one's time; the last holds for
+ * good. Without a script, DEFAULT_SCRIPT is used.
+ */
+
+#include "Host.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_MOTORS 10
+#define NUM_AXES 4
+#define MAX_SCRIPT_LINES 256
+#define SIM_WHEELS_MAX 8
+
+// the ultrasonic can't see further than this (cm); it reads 0, as if nothing were there.
+#define SIM_SONAR_RANGE 300
+
+// the gyro's reading wanders by up to this many counts either side of the true value.
+#define SIM_GYRO_NOISE 2
+
+/**
+ * one line of the joystick script.
+ */
+typedef struct {
+	unsigned long time;     // ms into driver control
+	int axis[NUM_AXES];
+	unsigned int buttons;   // 4 bits for each of groups 5-8: JOY_DOWN, JOY_LEFT, ...
+	unsigned int lcdButtons;
+} JoystickLine;
+
+// drive forward, turn on the spot, strafe, drive back, then stop.
+static const JoystickLine DEFAULT_SCRIPT[] = {
+	{0, {0, 0, 0, 0}, 0, 0},
+	{1000, {0, 80, 0, 0}, 0, 0},
+	{3000, {0, 0, 0, 60}, 0, 0},
+	{5000, {60, 0, 0, 0}, 0, 0},
+	{6000, {0, -80, 0, 0}, 0, 0},
+	{8000, {0, 0, 0, 0}, 0, 0}};
+
+// a robot with nothing wired up, for projects that have no host/Robot.c
+const SimRobot simRobot __attribute__((weak)) = {NULL, 0, 0, 0, 0, 0, 0, 0};
+
+static JoystickLine script[MAX_SCRIPT_LINES];
+static unsigned int scriptLength = 0;
+
+// guards everything the simulation thread moves on
+static pthread_mutex_t simLock = PTHREAD_MUTEX_INITIALIZER;
+
+static volatile int motorPower[NUM_MOTORS + 1];
+static double motorRpm[NUM_MOTORS + 1];
+static double motorAngle[NUM_MOTORS + 1]; // degrees the motor has turned, ever
+static double imeZero[NUM_MOTORS + 1];    // motorAngle when the IME was last reset
+
+static double x = 0, y = 0;  // cm from where the robot started; x is straight ahead
+static double heading = 0;   // degrees counter-clockwise
+static double turnRate = 0;  // degrees per second
+
+static volatile bool enabled = false;
+static volatile bool autonomous = false;
+static volatile unsigned long driverStart = 0;
+
+static unsigned char pinModes[BOARD_NR_GPIO_PINS + 1];
+static volatile bool pinOutput[BOARD_NR_GPIO_PINS + 1];   // what digitalWrite() set
+static volatile bool pinLevel[BOARD_NR_GPIO_PINS + 1];    // what the simulation drives
+static volatile bool pinDriven[BOARD_NR_GPIO_PINS + 1];   // is anything driving the pin?
+static InterruptHandler handlers[BOARD_NR_GPIO_PINS + 1];
+static unsigned char handlerEdges[BOARD_NR_GPIO_PINS + 1];
+
+static long quadTicks[SIM_WHEELS_MAX]; // the edges each encoder has been given so far
+
+static int analogZero[BOARD_NR_ADC_PINS + 1]; // from analogCalibrate()
+
+/**
+ * reads the driver's joystick moves from the file at path (see the top of this file for the
+ * format), or uses the built-in ones if path is NULL. Returns false if the file can't be read.
+ */
+bool simLoadJoystick(const char *path)
+{
+	if (path == NULL)
+	{
+		scriptLength = sizeof(DEFAULT_SCRIPT) / sizeof(DEFAULT_SCRIPT[0]);
+		memcpy(script, DEFAULT_SCRIPT, sizeof(DEFAULT_SCRIPT));
+		return true;
+	}
+	FILE *file = fopen(path, "r");
+	if (file == NULL)
+	{
+		fprintf(stderr, "can't read the joystick script %s\n", path);
+		return false;
+	}
+	char text[256];
+	int lineNumber = 0;
+	scriptLength = 0;
+	while (fgets(text, sizeof(text), file) != NULL && scriptLength < MAX_SCRIPT_LINES)
+	{
+		lineNumber++;
+		JoystickLine *line = &script[scriptLength];
+		int used = 0;
+		char first = text[strspn(text, " \t\r\n")];
+		if (first == '#' || first == '\0')
+			continue;
+		if (sscanf(text, "%lu %d %d %d %d%n", &line->time, &line->axis[0], &line->axis[1],
+		           &line->axis[2], &line->axis[3], &used) != 5)
+		{
+			fprintf(stderr, "%s:%d: expected a time and four axes\n", path, lineNumber);
+			fclose(file);
+			return false;
+		}
+		line->buttons = 0;
+		line->lcdButtons = 0;
+		for (char *button = strtok(text + used, " \t\r\n"); button != NULL;
+		     button = strtok(NULL, " \t\r\n"))
+		{
+			static const char DIRECTIONS[] = "DLUR"; // JOY_DOWN, JOY_LEFT, JOY_UP, JOY_RIGHT
+			static const char LCD[] = "LCR";         // LCD_BTN_LEFT, _CENTER, _RIGHT
+			if (strlen(button) == 5 && strncmp(button, "LCD-", 4) == 0 &&
+			    strchr(LCD, button[4]) != NULL)
+				line->lcdButtons |= 1 << (strchr(LCD, button[4]) - LCD);
+			else if (strlen(button) == 2 && button[0] >= '5' && button[0] <= '8' &&
+			         strchr(DIRECTIONS, button[1]) != NULL)
+				line->buttons |= (1 << (strchr(DIRECTIONS, button[1]) - DIRECTIONS))
+				                 << ((button[0] - '5') * 4);
+			else
+			{
+				fprintf(stderr, "%s:%d: no button called %s\n", path, lineNumber, button);
+				fclose(file);
+				return false;
+			}
+		}
+		scriptLength++;
+	}
+	fclose(file);
+	return true;
+}
+
+/**
+ * the joystick script line in force now, or NULL if the driver has no control.
+ */
+static const JoystickLine *joystickNow()
+{
+	if (!enabled || autonomous || scriptLength == 0)
+		return NULL;
+	unsigned long now = millis() - driverStart;
+	const JoystickLine *line = &script[0];
+	for (unsigned int i = 1; i < scriptLength && script[i].time <= now; i++)
+		line = &script[i];
+	return line;
+}
+
+/**
+ * sets the competition switch: enabled or disabled, autonomous or driver control. The joystick
+ * script starts again from the top each time driver control starts.
+ */
+void simSetMode(bool isEnabled, bool isAutonomous)
+{
+	if (isEnabled && !isAutonomous && (!enabled || autonomous))
+		driverStart = millis();
+	autonomous = isAutonomous;
+	enabled = isEnabled;
+}
+
+/**
+ * the power motor port actually gets: none while the robot is disabled.
+ */
+static int effectivePower(int port)
+{
+	return enabled ? motorPower[port] : 0;
+}
+
+/**
+ * gives one quadrature encoder the edges it has turned through since the last step, calling
+ * the pins' interrupt handlers as it goes.
+ */
+static void stepEncoder(unsigned int which, long ticks)
+{
+	// A and B for each quarter of a cycle, going forwards (see QUADRATURE_STEP in
+	// QuadratureEncoder.c)
+	static const unsigned char PHASES[4] = {0x0, 0x1, 0x3, 0x2};
+	const SimWheel *wheel = &simRobot.wheels[which];
+	while (quadTicks[which] != ticks)
+	{
+		quadTicks[which] += ticks > quadTicks[which] ? 1 : -1;
+		unsigned char phase = PHASES[quadTicks[which] & 3];
+		bool a = (phase & 2) != 0, b = (phase & 1) != 0;
+		unsigned char changed = pinLevel[wheel->quadA] != a ? wheel->quadA : wheel->quadB;
+		bool rising = pinLevel[wheel->quadA] != a ? a : b;
+		pinLevel[wheel->quadA] = a;
+		pinLevel[wheel->quadB] = b;
+		unsigned char wanted = rising ? INTERRUPT_EDGE_RISING : INTERRUPT_EDGE_FALLING;
+		if (handlers[changed] != NULL && (handlerEdges[changed] & wanted) != 0)
+			handlers[changed](changed);
+	}
+}
+
+/**
+ * moves the simulation on by dt seconds.
+ */
+static void step(double dt)
+{
+	double lag = dt / SIM_MOTOR_TIME_CONSTANT;
+	if (lag > 1)
+		lag = 1;
+	double sideSpeed[2] = {0, 0}; // left and right wheels' average, in degrees per second
+	unsigned int sideWheels[2] = {0, 0};
+	long ticks[SIM_WHEELS_MAX];
+
+	pthread_mutex_lock(&simLock);
+	for (int port = 1; port <= NUM_MOTORS; port++)
+	{
+		double target = effectivePower(port) * SIM_MOTOR_FREE_RPM / 127;
+		motorRpm[port] += (target - motorRpm[port]) * lag;
+		motorAngle[port] += motorRpm[port] * 6 * dt;
+	}
+	for (unsigned int i = 0; i < simRobot.numWheels && i < SIM_WHEELS_MAX; i++)
+	{
+		const SimWheel *wheel = &simRobot.wheels[i];
+		int side = wheel->side == SIM_RIGHT;
+		sideSpeed[side] += motorRpm[wheel->motor] * 6 * wheel->orientation;
+		sideWheels[side]++;
+		ticks[i] = (long)floor(motorAngle[wheel->motor] * wheel->orientation *
+		                       wheel->quadOrientation * SIM_QUAD_TICKS_PER_TURN / 360);
+	}
+	for (int side = 0; side < 2; side++)
+		if (sideWheels[side] > 0)
+			sideSpeed[side] /= sideWheels[side];
+
+	// wheel degrees per second are also quadrature ticks per second
+	double forward = (sideSpeed[0] + sideSpeed[1]) / 2 / 360 * simRobot.wheelCircumference;
+	turnRate = simRobot.ticksPerTurn > 0 ?
+	           (sideSpeed[1] - sideSpeed[0]) / 2 / simRobot.ticksPerTurn * 360 : 0;
+	heading += turnRate * dt;
+	x += forward * cos(heading * M_PI / 180) * dt;
+	y += forward * sin(heading * M_PI / 180) * dt;
+	pthread_mutex_unlock(&simLock);
+
+	// the interrupts run outside the lock, as they may read the sensors.
+	for (unsigned int i = 0; i < simRobot.numWheels && i < SIM_WHEELS_MAX; i++)
+		if (simRobot.wheels[i].quadA != 0)
+			stepEncoder(i, ticks[i]);
+}
+
+/**
+ * the simulation thread.
+ */
+static void *simThread(void *ignore)
+{
+	unsigned long last = micros();
+	while (true)
+	{
+		hostSleep(SIM_PERIOD_US);
+		unsigned long now = micros();
+		step((now - last) / 1e6);
+		last = now;
+	}
+	return NULL;
+}
+
+/**
+ * starts the simulation running, in a thread of its own.
+ */
+void simStart()
+{
+	for (unsigned int i = 0; i < simRobot.numWheels && i < SIM_WHEELS_MAX; i++)
+	{
+		const SimWheel *wheel = &simRobot.wheels[i];
+		if (wheel->quadA != 0)
+		{
+			pinDriven[wheel->quadA] = true;
+			pinDriven[wheel->quadB] = true;
+		}
+	}
+	pthread_t thread;
+	pthread_create(&thread, NULL, simThread, NULL);
+	pthread_detach(thread);
+}
+
+/**
+ * prints where the simulated robot is, and what each motor is doing.
+ */
+void simReport(FILE *stream)
+{
+	pthread_mutex_lock(&simLock);
+	fprintf(stream, "robot at x %.1f cm, y %.1f cm, heading %.1f deg\n", x, y, heading);
+	for (int port = 1; port <= NUM_MOTORS; port++)
+		if (motorAngle[port] != 0 || motorPower[port] != 0)
+			fprintf(stream, "motor %2d: power %4d, %6.1f rpm, turned %.1f times\n", port,
+			        motorPower[port], motorRpm[port], motorAngle[port] / 360);
+	pthread_mutex_unlock(&simLock);
+}
+
+// -------------------------  competition switch and joystick --------------------------
+
+bool isEnabled()
+{
+	return enabled;
+}
+
+bool isAutonomous()
+{
+	return autonomous;
+}
+
+/**
+ * there is no field to be connected to.
+ */
+bool isOnline()
+{
+	return false;
+}
+
+bool isJoystickConnected(unsigned char joystick)
+{
+	return joystick == 1;
+}
+
+int joystickGetAnalog(unsigned char joystick, unsigned char axis)
+{
+	const JoystickLine *line = joystickNow();
+	if (line == NULL || joystick != 1 || axis < 1 || axis > NUM_AXES)
+		return 0;
+	int value = line->axis[axis - 1];
+	return value > 127 ? 127 : value < -127 ? -127 : value;
+}
+
+bool joystickGetDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button)
+{
+	const JoystickLine *line = joystickNow();
+	if (line == NULL || joystick != 1 || buttonGroup < 5 || buttonGroup > 8)
+		return false;
+	return ((line->buttons >> ((buttonGroup - 5) * 4)) & button) != 0;
+}
+
+/**
+ * the LCD's buttons that are held down, as lcdReadButtons() gives them.
+ */
+unsigned int simLcdButtons()
+{
+	// the LCD works whatever the competition switch says, so this doesn't use joystickNow().
+	if (scriptLength == 0)
+		return 0;
+	unsigned long now = millis() - driverStart;
+	unsigned int buttons = script[0].lcdButtons;
+	for (unsigned int i = 1; i < scriptLength && script[i].time <= now; i++)
+		buttons = script[i].lcdButtons;
+	return buttons;
+}
+
+unsigned int powerLevelMain()
+{
+	int load = 0;
+	for (int port = 1; port <= NUM_MOTORS; port++)
+		load += abs(effectivePower(port));
+	return SIM_BATTERY_MV - load * SIM_BATTERY_SAG / 127;
+}
+
+/**
+ * there is no backup battery.
+ */
+unsigned int powerLevelBackup()
+{
+	return 0;
+}
+
+void setTeamName(const char *name)
+{
+}
+
+// -------------------------  motors --------------------------
+
+int motorGet(unsigned char channel)
+{
+	if (channel < 1 || channel > NUM_MOTORS)
+		return 0;
+	return motorPower[channel];
+}
+
+void motorSet(unsigned char channel, int speed)
+{
+	if (channel < 1 || channel > NUM_MOTORS)
+		return;
+	motorPower[channel] = speed > 127 ? 127 : speed < -127 ? -127 : speed;
+}
+
+void motorStop(unsigned char channel)
+{
+	motorSet(channel, 0);
+}
+
+void motorStopAll()
+{
+	for (int port = 1; port <= NUM_MOTORS; port++)
+		motorPower[port] = 0;
+}
+
+// -------------------------  digital and analog pins --------------------------
+
+void pinMode(unsigned char pin, unsigned char mode)
+{
+	if (pin <= BOARD_NR_GPIO_PINS)
+		pinModes[pin] = mode;
+}
+
+void digitalWrite(unsigned char pin, bool value)
+{
+	if (pin <= BOARD_NR_GPIO_PINS)
+		pinOutput[pin] = value;
+}
+
+/**
+ * an output reads back what was written to it; an input nothing is driving reads HIGH, as
+ * the Cortex's pull-ups make unplugged pins do.
+ */
+bool digitalRead(unsigned char pin)
+{
+	if (pin > BOARD_NR_GPIO_PINS)
+		return false;
+	if (pinModes[pin] == OUTPUT || pinModes[pin] == OUTPUT_OD)
+		return pinOutput[pin];
+	return pinDriven[pin] ? pinLevel[pin] : true;
+}
+
+void ioSetInterrupt(unsigned char pin, unsigned char edges, InterruptHandler handler)
+{
+	if (pin > BOARD_NR_GPIO_PINS)
+		return;
+	handlerEdges[pin] = edges;
+	handlers[pin] = handler;
+}
+
+void ioClearInterrupt(unsigned char pin)
+{
+	if (pin <= BOARD_NR_GPIO_PINS)
+		handlers[pin] = NULL;
+}
+
+/**
+ * the gyro's port reads its bias plus the turn rate; every other port is unplugged (0).
+ */
+int analogRead(unsigned char channel)
+{
+	static unsigned int noise = 12345;
+	if (channel == 0 || channel != simRobot.gyroPort)
+		return 0;
+	noise = noise * 1103515245 + 12345;
+	pthread_mutex_lock(&simLock);
+	double rate = turnRate;
+	pthread_mutex_unlock(&simLock);
+	int value = SIM_GYRO_BIAS + (int)lround(rate * simRobot.gyroCountsPerDps) +
+	            (int)((noise >> 16) % (2 * SIM_GYRO_NOISE + 1)) - SIM_GYRO_NOISE;
+	return value < 0 ? 0 : value > 4095 ? 4095 : value;
+}
+
+int analogCalibrate(unsigned char channel)
+{
+	if (channel < 1 || channel > BOARD_NR_ADC_PINS)
+		return 0;
+	int sum = 0;
+	for (int i = 0; i < 1024; i++)
+		sum += analogRead(channel);
+	analogZero[channel] = sum / 1024;
+	return analogZero[channel];
+}
+
+int analogReadCalibrated(unsigned char channel)
+{
+	if (channel < 1 || channel > BOARD_NR_ADC_PINS)
+		return 0;
+	return analogRead(channel) - analogZero[channel];
+}
+
+int analogReadCalibratedHR(unsigned char channel)
+{
+	return analogReadCalibrated(channel) * 16;
+}
+
+// -------------------------  sensors --------------------------
+
+/**
+ * the wheel whose motor has the given IME address, or NULL if there isn't one.
+ */
+static const SimWheel *imeWheel(unsigned char address)
+{
+	for (unsigned int i = 0; i < simRobot.numWheels; i++)
+		if (simRobot.wheels[i].ime == address)
+			return &simRobot.wheels[i];
+	return NULL;
+}
+
+unsigned int imeInitializeAll()
+{
+	unsigned int found = 0;
+	while (imeWheel(found) != NULL)
+		found++;
+	return found;
+}
+
+bool imeGet(unsigned char address, int *value)
+{
+	const SimWheel *wheel = imeWheel(address);
+	if (wheel == NULL)
+		return false;
+	pthread_mutex_lock(&simLock);
+	*value = (int)((motorAngle[wheel->motor] - imeZero[wheel->motor]) * SIM_IME_TICKS_PER_TURN /
+	               360);
+	pthread_mutex_unlock(&simLock);
+	return true;
+}
+
+bool imeGetVelocity(unsigned char address, int *value)
+{
+	const SimWheel *wheel = imeWheel(address);
+	if (wheel == NULL)
+		return false;
+	pthread_mutex_lock(&simLock);
+	*value = (int)(motorRpm[wheel->motor] * SIM_IME_VELOCITY_SCALE);
+	pthread_mutex_unlock(&simLock);
+	return true;
+}
+
+bool imeReset(unsigned char address)
+{
+	const SimWheel *wheel = imeWheel(address);
+	if (wheel == NULL)
+		return false;
+	pthread_mutex_lock(&simLock);
+	imeZero[wheel->motor] = motorAngle[wheel->motor];
+	pthread_mutex_unlock(&simLock);
+	return true;
+}
+
+void imeShutdown()
+{
+}
+
+/**
+ * the PROS gyro, encoder and ultrasonic handles are one of these, each.
+ */
+typedef struct {
+	unsigned char port;
+	double zero; // reading when it was last reset
+	bool reverse;
+} SimSensor;
+
+static SimSensor gyros[BOARD_NR_ADC_PINS + 1];     // by analog port
+static SimSensor sensors[BOARD_NR_GPIO_PINS + 1];  // by digital pin
+
+Gyro gyroInit(unsigned char port, unsigned short multiplier)
+{
+	if (port < 1 || port > BOARD_NR_ADC_PINS)
+		return NULL;
+	gyros[port].port = port;
+	gyroReset(&gyros[port]);
+	return &gyros[port];
+}
+
+/**
+ * whole degrees turned since gyroReset(), if the gyro is the one in simRobot.
+ */
+int gyroGet(Gyro gyro)
+{
+	SimSensor *sensor = gyro;
+	if (sensor->port != simRobot.gyroPort)
+		return 0;
+	pthread_mutex_lock(&simLock);
+	int degrees = (int)(heading - sensor->zero);
+	pthread_mutex_unlock(&simLock);
+	return degrees;
+}
+
+void gyroReset(Gyro gyro)
+{
+	SimSensor *sensor = gyro;
+	pthread_mutex_lock(&simLock);
+	sensor->zero = heading;
+	pthread_mutex_unlock(&simLock);
+}
+
+void gyroShutdown(Gyro gyro)
+{
+}
+
+/**
+ * the wheel whose quadrature encoder is on the given pin, or -1.
+ */
+static int encoderWheel(unsigned char pin)
+{
+	for (unsigned int i = 0; i < simRobot.numWheels && i < SIM_WHEELS_MAX; i++)
+		if (pin != 0 && (simRobot.wheels[i].quadA == pin || simRobot.wheels[i].quadB == pin))
+			return i;
+	return -1;
+}
+
+Encoder encoderInit(unsigned char portTop, unsigned char portBottom, bool reverse)
+{
+	if (portTop > BOARD_NR_GPIO_PINS)
+		return NULL;
+	sensors[portTop].port = portTop;
+	sensors[portTop].reverse = reverse;
+	encoderReset(&sensors[portTop]);
+	return &sensors[portTop];
+}
+
+int encoderGet(Encoder enc)
+{
+	SimSensor *sensor = enc;
+	int wheel = encoderWheel(sensor->port);
+	if (wheel < 0)
+		return 0;
+	int ticks = (int)(quadTicks[wheel] - sensor->zero);
+	return sensor->reverse ? -ticks : ticks;
+}
+
+void encoderReset(Encoder enc)
+{
+	SimSensor *sensor = enc;
+	int wheel = encoderWheel(sensor->port);
+	sensor->zero = wheel >= 0 ? quadTicks[wheel] : 0;
+}
+
+void encoderShutdown(Encoder enc)
+{
+}
+
+Ultrasonic ultrasonicInit(unsigned char portEcho, unsigned char portPing)
+{
+	if (portEcho > BOARD_NR_GPIO_PINS)
+		return NULL;
+	sensors[portEcho].port = portEcho;
+	return &sensors[portEcho];
+}
+
+/**
+ * cm to the wall in front of where the robot started, or 0 if it is out of range.
+ */
+int ultrasonicGet(Ultrasonic ult)
+{
+	SimSensor *sensor = ult;
+	if (sensor->port != simRobot.sonarEcho || sensor->port == 0)
+		return 0;
+	pthread_mutex_lock(&simLock);
+	double distance = simRobot.wallDistance - x;
+	pthread_mutex_unlock(&simLock);
+	return distance < 1 || distance > SIM_SONAR_RANGE ? 0 : (int)distance;
+}
+
+void ultrasonicShutdown(Ultrasonic ult)
+{
+}
+
+/**
+ * there is nothing on the I2C bus but the IMEs, which are above.
+ */
+bool i2cRead(uint8_t addr, uint8_t *data, uint16_t count)
+{
+	return false;
+}
+
+bool i2cReadRegister(uint8_t addr, uint8_t reg, uint8_t *value, uint16_t count)
+{
+	return false;
+}
+
+bool i2cWrite(uint8_t addr, uint8_t *data, uint16_t count)
+{
+	return false;
+}
+
+bool i2cWriteRegister(uint8_t addr, uint8_t reg, uint16_t value)
+{
+	return false;
+}
+
+/**
+ * the speaker is silent.
+ */
+void speakerInit()
+{
+}
+
+void speakerPlayArray(const char **songs)
+{
+}
+
+void speakerPlayRtttl(const char *song)
+{
+}
+
+void speakerShutdown()
+{
+}
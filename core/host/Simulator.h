@@ -0,0 +1,71 @@
+/** @file Simulator.h
+ * @brief How a robot is put together, for the simulator the PC build runs against
+ *
+ * The simulator (Simulator.c) turns each motor's power into a speed, and from the drive
+ * wheels works out where the robot is - and so what its encoders, IMEs, gyro and ultrasonic
+ * would read. It only knows which motor is which from simRobot, which a project defines in
+ * host/Robot.c (built by "make host", never for the robot). Without one the motors still
+ * run, but no sensor sees them move.
+ *
+ * The drive is treated as a tank drive: the left wheels and the right wheels. Mecanum wheels
+ * strafing sideways aren't modelled, only driving and turning.
+ */
+
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+// which side of the robot a wheel is on
+#define SIM_LEFT -1
+#define SIM_RIGHT 1
+
+// a simulated motor's speed at full power, and how long (the time constant, in seconds) it
+// takes to get most of the way to a new speed: about a 393 motor with a wheel on it.
+#define SIM_MOTOR_FREE_RPM 100.0
+#define SIM_MOTOR_TIME_CONSTANT 0.1
+
+// counts per turn of a quadrature encoder (every edge of both wires) and of a 393 IME in
+// high torque mode. An IME's velocity is the wheel's RPM times SIM_IME_VELOCITY_SCALE.
+#define SIM_QUAD_TICKS_PER_TURN 360
+#define SIM_IME_TICKS_PER_TURN 627.2
+#define SIM_IME_VELOCITY_SCALE 39.2
+
+// the ADC reading of a gyro that isn't turning, and the battery voltage (mV) with the motors
+// off. Each motor at full power pulls it down by SIM_BATTERY_SAG.
+#define SIM_GYRO_BIAS 1850
+#define SIM_BATTERY_MV 8000
+#define SIM_BATTERY_SAG 150
+
+// the physics (and the encoders' edges) are worked out every SIM_PERIOD_US microseconds.
+#define SIM_PERIOD_US 1000
+
+/**
+ * one drive wheel, and the sensors that watch it.
+ */
+typedef struct {
+	unsigned char motor;        // motor port, 1-10
+	int orientation;            // the port's PORT_ORIENTATION_n: which way it is wired
+	int side;                   // SIM_LEFT or SIM_RIGHT
+	unsigned char quadA, quadB; // digital pins of a quadrature encoder on the wheel, or 0
+	int quadOrientation;        // PORT_ORIENTATION_REVERSED if it counts down going forward
+	int ime;                    // address of the IME on the wheel's motor, or -1 for none
+} SimWheel;
+
+/**
+ * the whole robot, as far as the simulator cares.
+ */
+typedef struct {
+	const SimWheel *wheels;
+	unsigned int numWheels;
+	double wheelCircumference; // cm
+	// encoder ticks (the right wheels' average minus the left wheels', halved) for the robot
+	// to turn one full circle on the spot
+	double ticksPerTurn;
+	unsigned char gyroPort;     // analog port (1-8) of a gyro, or 0
+	double gyroCountsPerDps;    // how far the gyro's reading moves per degree per second
+	unsigned char sonarEcho;    // digital pin of an ultrasonic's echo (orange) wire, or 0
+	double wallDistance;        // cm from where the robot starts to the wall it faces
+} SimRobot;
+
+extern const SimRobot simRobot;
+
+#endif
@@ -0,0 +1,69 @@
+# Makefile for building a robot project to run on a PC ("make host" in the project folder)
+#
+# The same src/*.c and core/src/*.c that go on the robot are compiled with the PC's own
+# compiler and linked with core/host: a stand-in for the PROS library (see Host.h) and a
+# simulated robot for the code to drive (Simulator.h). A project says how its robot is wired
+# for the simulator in host/*.c, which is only built here. Each bench/*.c is a benchmark
+# program of its own, built from just that file and the core headers.
+#
+#   bin/host/robot     the robot program; "bin/host/robot --help" lists its options
+#   bin/host/<bench>   one for each bench/<bench>.c
+#
+# The top-level Makefile runs this with ROOT and CORE set as in common.mk.
+
+HOSTCC?=cc
+HOSTAR?=ar
+# Optimization for the host build; e.g. "make host HOSTOPT=-O0" to debug
+HOSTOPT?=-O2
+HOSTBIN=$(ROOT)/bin/host
+# -fcommon: the robot code has variables declared in more than one file (e.g. in main.h)
+# that arm-none-eabi-gcc merges, but newer PC compilers don't by default.
+HOSTCFLAGS=-std=gnu99 -Wall -g $(HOSTOPT) -fsigned-char -fcommon -pthread
+# the robot code and the core see the shim's renames first (see ProsHost.h)
+HOSTROBOTFLAGS=$(HOSTCFLAGS) -include $(CORE)/host/ProsHost.h -I$(ROOT)/include -I$(ROOT)/src \
+	-I$(CORE)/include -I$(CORE)/host
+HOSTSHIMFLAGS=$(HOSTCFLAGS) -I$(CORE)/include
+
+ROBOT_OBJ:=$(patsubst $(ROOT)/src/%.c,$(HOSTBIN)/%.o,$(wildcard $(ROOT)/src/*.c))
+WIRING_OBJ:=$(patsubst $(ROOT)/host/%.c,$(HOSTBIN)/wiring/%.o,$(wildcard $(ROOT)/host/*.c))
+CORE_OBJ:=$(patsubst $(CORE)/src/%.c,$(HOSTBIN)/core/%.o,$(wildcard $(CORE)/src/*.c))
+SHIM_OBJ:=$(patsubst $(CORE)/host/%.c,$(HOSTBIN)/shim/%.o,$(wildcard $(CORE)/host/*.c))
+BENCH:=$(patsubst $(ROOT)/bench/%.c,$(HOSTBIN)/%,$(wildcard $(ROOT)/bench/*.c))
+HOSTLIB=$(HOSTBIN)/libkcore.a
+HEADERS:=$(wildcard $(ROOT)/include/*.h $(ROOT)/src/*.h $(CORE)/include/*.h $(CORE)/host/*.h)
+
+.PHONY: all
+
+all: $(HOSTBIN)/robot $(BENCH)
+
+$(HOSTBIN) $(HOSTBIN)/wiring $(HOSTBIN)/core $(HOSTBIN)/shim:
+	-@mkdir -p $@
+
+# The core is archived, as for the robot, so a project only gets the parts it uses.
+$(HOSTLIB): $(CORE_OBJ)
+	@echo AR $@
+	@$(HOSTAR) rcs $@ $(CORE_OBJ)
+
+$(HOSTBIN)/robot: $(ROBOT_OBJ) $(WIRING_OBJ) $(SHIM_OBJ) $(HOSTLIB)
+	@echo LN $@
+	@$(HOSTCC) $(HOSTCFLAGS) $(ROBOT_OBJ) $(WIRING_OBJ) $(SHIM_OBJ) $(HOSTLIB) -lm -o $@
+
+$(ROBOT_OBJ): $(HOSTBIN)/%.o: $(ROOT)/src/%.c $(HEADERS) | $(HOSTBIN)
+	@echo HOSTCC $<
+	@$(HOSTCC) $(HOSTROBOTFLAGS) -c -o $@ $<
+
+$(WIRING_OBJ): $(HOSTBIN)/wiring/%.o: $(ROOT)/host/%.c $(HEADERS) | $(HOSTBIN)/wiring
+	@echo HOSTCC $<
+	@$(HOSTCC) $(HOSTROBOTFLAGS) -c -o $@ $<
+
+$(CORE_OBJ): $(HOSTBIN)/core/%.o: $(CORE)/src/%.c $(HEADERS) | $(HOSTBIN)/core
+	@echo HOSTCC $<
+	@$(HOSTCC) $(HOSTROBOTFLAGS) -c -o $@ $<
+
+$(SHIM_OBJ): $(HOSTBIN)/shim/%.o: $(CORE)/host/%.c $(HEADERS) | $(HOSTBIN)/shim
+	@echo HOSTCC $<
+	@$(HOSTCC) $(HOSTSHIMFLAGS) -c -o $@ $<
+
+$(BENCH): $(HOSTBIN)/%: $(ROOT)/bench/%.c $(HEADERS) | $(HOSTBIN)
+	@echo HOSTCC $<
+	@$(HOSTCC) $(HOSTCFLAGS) -I$(CORE)/include -o $@ $< -lm
@@ -0,0 +1,131 @@
+/** @file Format.h
+ * @brief Quick number-to-text for the loops that run every cycle
+ *
+ * printf(), lcdPrint() and snprintf() read through the format string every time they are
+ * called, character by character, to work out what to print - and need a few hundred bytes
+ * of stack to do it. In a 20 ms loop that is wasted time. K_format() does the same job with
+ * the format decided when the code is compiled: each piece is a direct call to a small
+ * function that writes straight into your buffer, so there is nothing to parse, and the
+ * compiler checks each value's type against the piece it is given to.
+ *
+ *   char line[LCD_LINE_LENGTH + 1];
+ *   K_format(line, sizeof(line), K_STR("Field "), K_INT(heading, 4), K_STR(" deg"));
+ *   lcdSetText(uart1, 2, line);
+ *
+ * is the same as lcdPrint(uart1, 2, "Field %4d deg", heading). The pieces are:
+ *
+ *   K_STR(text)                    %s
+ *   K_STR_PAD(text, width)         %-<width>s  (text, then spaces up to width)
+ *   K_INT(value, width)            %<width>ld  (right-aligned; width 0 for no padding)
+ *   K_UINT(value, width)           %<width>lu
+ *   K_FIXED(value, places, width)  value / 10^places with that many decimal places: e.g.
+ *                                  K_FIXED(123, 1, 5) is " 12.3", the same as
+ *                                  "%3d.%d", 123 / 10, 123 % 10
+ *   K_CHAR(c)                      %c
+ *
+ * K_format() always ends the text with '\0', cutting it short if the buffer is too small,
+ * and gives back the length of the text. bench/format_bench.c compares it with snprintf().
+ */
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stddef.h>
+
+/**
+ * the pieces: each writes at "out" (but never at or past "end") and returns where the next
+ * piece should go. Use them through K_format() rather than directly.
+ */
+static inline char *formatChar(char *out, char *end, char c)
+{
+	if (out < end)
+		*out++ = c;
+	return out;
+}
+
+static inline char *formatString(char *out, char *end, const char *text)
+{
+	while (*text != '\0' && out < end)
+		*out++ = *text++;
+	return out;
+}
+
+static inline char *formatStringPadded(char *out, char *end, const char *text, int width)
+{
+	char *start = out;
+	out = formatString(out, end, text);
+	while (out - start < width && out < end)
+		*out++ = ' ';
+	return out;
+}
+
+/**
+ * writes the digits of "magnitude" (with a '-' if negative), putting a '.' before the last
+ * "places" digits, right-aligned in "width" characters.
+ */
+static inline char *formatDigits(char *out, char *end, unsigned long magnitude, int negative,
+                                 int places, int width)
+{
+	char digits[24]; // enough for a 64-bit long, on a PC
+	int count = 0;
+	// backwards, lowest digit first; at least places + 1 digits, so 5 with 2 places is 0.05.
+	do
+	{
+		digits[count++] = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude != 0 || count <= places);
+
+	int length = count + negative + (places > 0);
+	for (; length < width; length++)
+		out = formatChar(out, end, ' ');
+	if (negative)
+		out = formatChar(out, end, '-');
+	while (count > 0)
+	{
+		if (count == places)
+			out = formatChar(out, end, '.');
+		out = formatChar(out, end, digits[--count]);
+	}
+	return out;
+}
+
+static inline char *formatInt(char *out, char *end, long value, int width)
+{
+	unsigned long magnitude = value < 0 ? -(unsigned long)value : (unsigned long)value;
+	return formatDigits(out, end, magnitude, value < 0, 0, width);
+}
+
+static inline char *formatUnsigned(char *out, char *end, unsigned long value, int width)
+{
+	return formatDigits(out, end, value, 0, 0, width);
+}
+
+static inline char *formatFixed(char *out, char *end, long value, int places, int width)
+{
+	unsigned long magnitude = value < 0 ? -(unsigned long)value : (unsigned long)value;
+	return formatDigits(out, end, magnitude, value < 0, places, width);
+}
+
+#define K_STR(text) (K_out_ = formatString(K_out_, K_end_, (text)))
+#define K_STR_PAD(text, width) (K_out_ = formatStringPadded(K_out_, K_end_, (text), (width)))
+#define K_INT(value, width) (K_out_ = formatInt(K_out_, K_end_, (value), (width)))
+#define K_UINT(value, width) (K_out_ = formatUnsigned(K_out_, K_end_, (value), (width)))
+#define K_FIXED(value, places, width) \
+	(K_out_ = formatFixed(K_out_, K_end_, (value), (places), (width)))
+#define K_CHAR(c) (K_out_ = formatChar(K_out_, K_end_, (c)))
+
+/**
+ * writes the pieces (K_STR(), K_INT() and so on), one after another, into "buffer", which
+ * holds "size" characters. Returns the length of the text (not counting the '\0').
+ */
+#define K_format(buffer, size, ...)                                                         \
+	({                                                                                      \
+		char *K_start_ = (buffer);                                                          \
+		char *K_out_ = K_start_;                                                            \
+		char *K_end_ = K_start_ + (size) - 1;                                               \
+		__VA_ARGS__;                                                                        \
+		*K_out_ = '\0';                                                                     \
+		(int)(K_out_ - K_start_);                                                           \
+	})
+
+#endif
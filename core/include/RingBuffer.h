@@ -0,0 +1,179 @@
+/** @file RingBuffer.h
+ * @brief Lock-free ways for one task (or interrupt) to hand data to another
+ *
+ * mutexCreate() and semaphoreCreate() work, but every take/give can mean a context switch,
+ * and a low-priority task holding a mutex can hold up a high-priority one. For the common
+ * case of exactly one writer and one reader, we don't need them. This file has two tools:
+ *
+ * RING_BUFFER_DECLARE(Name, type, size) - a queue. The writer pushes items in, the reader
+ *   pops them out in the same order. If the reader falls behind and the ring is full, the
+ *   push fails (nothing is overwritten). Only one task/interrupt may push, and only one may
+ *   pop.
+ *
+ * MAILBOX_DECLARE(Name, type) - a "latest value" slot. The writer publishes a whole new
+ *   value whenever it likes; any number of readers copy out the most recent one. Readers
+ *   never see half of an update, and the writer never waits for them. Only one task may
+ *   publish.
+ *
+ * Each declares a type called Name and inline functions called Name<Something>, e.g.
+ *
+ *   RING_BUFFER_DECLARE(EdgeRing, EncoderEdge, 64)
+ *   static EdgeRing edges;
+ *   ...
+ *   EdgeRingPush(&edges, &edge);      // in the interrupt
+ *   while (EdgeRingPop(&edges, &edge)) // in the task
+ *
+ * Both only ever need one word written at a time to be seen by the other side "all at once,"
+ * which the Cortex-M3 does for aligned 32-bit words, plus a "dmb" barrier so the data is
+ * written before the index that announces it. (The LDREX/STREX instructions are only needed
+ * when two writers race for the same word, which these never do.) Built for a PC, the same
+ * code uses C11 atomics instead.
+ */
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__arm__)
+
+// an index shared between the two sides.
+typedef volatile unsigned int RingIndex;
+
+// reads an index the other side writes; anything read after this sees what was written
+// before the other side stored that index.
+static inline unsigned int ringLoadAcquire(RingIndex *index)
+{
+	unsigned int value = *index;
+	__asm__ volatile ("dmb" ::: "memory");
+	return value;
+}
+
+// stores an index; everything written before this is visible before the new index is.
+static inline void ringStoreRelease(RingIndex *index, unsigned int value)
+{
+	__asm__ volatile ("dmb" ::: "memory");
+	*index = value;
+}
+
+// keeps reads on either side of it in order (see MAILBOX_DECLARE).
+static inline void ringReadFence()
+{
+	__asm__ volatile ("dmb" ::: "memory");
+}
+
+#else
+
+#include <stdatomic.h>
+
+typedef _Atomic unsigned int RingIndex;
+
+static inline unsigned int ringLoadAcquire(RingIndex *index)
+{
+	return atomic_load_explicit(index, memory_order_acquire);
+}
+
+static inline void ringStoreRelease(RingIndex *index, unsigned int value)
+{
+	atomic_store_explicit(index, value, memory_order_release);
+}
+
+static inline void ringReadFence()
+{
+	atomic_thread_fence(memory_order_acquire);
+}
+
+#endif
+
+/**
+ * declares a single-producer/single-consumer queue type "Name" holding up to "size" items of
+ * "type" ("size" must be a power of two), along with:
+ *   bool NamePush(Name *ring, const type *item)  - false if the ring is full
+ *   bool NamePop(Name *ring, type *item)         - false if the ring is empty
+ *   unsigned int NameCount(Name *ring)           - how many items are waiting
+ * A ring that is all zeros (e.g. a global or static variable) is empty and ready to use.
+ */
+#define RING_BUFFER_DECLARE(Name, type, size)                                               \
+	typedef struct {                                                                        \
+		type items[size];                                                                   \
+		RingIndex head; /* next slot to fill; only the producer changes it */               \
+		RingIndex tail; /* next slot to empty; only the consumer changes it */              \
+	} Name;                                                                                 \
+                                                                                            \
+	static inline bool Name##Push(Name *ring, const type *item)                             \
+	{                                                                                       \
+		unsigned int head = ringLoadAcquire(&ring->head);                                   \
+		if (head - ringLoadAcquire(&ring->tail) >= (size))                                  \
+			return false;                                                                   \
+		ring->items[head % (size)] = *item;                                                 \
+		ringStoreRelease(&ring->head, head + 1);                                            \
+		return true;                                                                        \
+	}                                                                                       \
+                                                                                            \
+	static inline bool Name##Pop(Name *ring, type *item)                                    \
+	{                                                                                       \
+		unsigned int tail = ringLoadAcquire(&ring->tail);                                   \
+		if (tail == ringLoadAcquire(&ring->head))                                           \
+			return false;                                                                   \
+		*item = ring->items[tail % (size)];                                                 \
+		ringStoreRelease(&ring->tail, tail + 1);                                            \
+		return true;                                                                        \
+	}                                                                                       \
+                                                                                            \
+	static inline unsigned int Name##Count(Name *ring)                                      \
+	{                                                                                       \
+		return ringLoadAcquire(&ring->head) - ringLoadAcquire(&ring->tail);                 \
+	}
+
+/**
+ * declares a single-writer "latest value" mailbox type "Name" holding a "type", along with:
+ *   type *NameBegin(Name *box)                  - writer: the spare copy to fill in
+ *   void NameCommit(Name *box)                  - writer: make the spare copy the latest
+ *   void NamePublish(Name *box, const type *v)  - writer: Begin + copy + Commit
+ *   const type *NameCurrent(Name *box)          - WRITER ONLY: peek at the latest value
+ *   void NameRead(Name *box, type *copy)        - anyone: copy out the latest value
+ * There are two copies of the value; the writer fills in the one readers aren't being
+ * pointed at, then flips. A reader that gets interrupted by a publish while copying notices
+ * (the version changed) and copies again. A mailbox that is all zeros holds an all-zero
+ * value.
+ */
+#define MAILBOX_DECLARE(Name, type)                                                         \
+	typedef struct {                                                                        \
+		type slot[2];                                                                       \
+		RingIndex version; /* readers use slot[version % 2] */                              \
+	} Name;                                                                                 \
+                                                                                            \
+	static inline type *Name##Begin(Name *box)                                              \
+	{                                                                                       \
+		return &box->slot[(ringLoadAcquire(&box->version) + 1) % 2];                        \
+	}                                                                                       \
+                                                                                            \
+	static inline void Name##Commit(Name *box)                                              \
+	{                                                                                       \
+		ringStoreRelease(&box->version, ringLoadAcquire(&box->version) + 1);                \
+	}                                                                                       \
+                                                                                            \
+	static inline void Name##Publish(Name *box, const type *value)                          \
+	{                                                                                       \
+		*Name##Begin(box) = *value;                                                         \
+		Name##Commit(box);                                                                  \
+	}                                                                                       \
+                                                                                            \
+	static inline const type *Name##Current(Name *box)                                      \
+	{                                                                                       \
+		return &box->slot[ringLoadAcquire(&box->version) % 2];                              \
+	}                                                                                       \
+                                                                                            \
+	static inline void Name##Read(Name *box, type *copy)                                    \
+	{                                                                                       \
+		unsigned int version;                                                               \
+		do                                                                                  \
+		{                                                                                   \
+			version = ringLoadAcquire(&box->version);                                       \
+			memcpy(copy, (const void *)&box->slot[version % 2], sizeof(type));              \
+			ringReadFence();                                                                \
+		} while (version != ringLoadAcquire(&box->version));                                \
+	}
+
+#endif
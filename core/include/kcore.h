@@ -0,0 +1,490 @@
+/** @file kcore.h
+ * @brief The code every one of our robots shares
+ *
+ * Everything in core/ is built once, into core/bin/libkcore.a, and linked into every robot
+ * project (Clawbot, Mecanum 2017, GitTest): the motor layer, input shaping, the stack
+ * monitor, the profiler and deadlines, the sensor registry, telemetry, the arena and object
+ * pools, checksums, COBS framing, RingBuffer.h and Format.h. So when one of these gets
+ * faster or safer, every robot gets it at the next build. Each project's main.h includes
+ * this file, and the project's common.mk includes core/common.mk, which builds the library
+ * first and links it.
+ *
+ * The library has nothing robot-specific in it. What differs between robots is supplied by
+ * the project, in one of its own source files:
+ *
+ *  - K_MOTOR_DIRECTIONS; once, after PORT_ORIENTATION_1 to PORT_ORIENTATION_10 are defined
+ *    (in main.h). Needed by anything that uses K_setMotor() and friends.
+ *  - K_ARENA(size); once. Needed by anything that uses arenaAlloc() or poolInit().
+ *  - K_SENSORS(list); once, with the robot's list of sensors. Needed by anything that uses
+ *    the sensor registry (sensorRegistryInit() and friends).
+ *  - K_TELEMETRY(type); once, with the robot's telemetry frame type. Needed by anything that
+ *    uses telemetryInit() and friends.
+ *
+ * A robot that never calls, say, the profiler doesn't get it: the linker only takes the
+ * parts of an archive that are used.
+ */
+
+#ifndef KCORE_H_
+#define KCORE_H_
+
+#define PORT_ORIENTATION_NORMAL 1
+#define PORT_ORIENTATION_REVERSED -1
+
+// starting value for crc16()
+#define CRC16_INITIAL 0xFFFF
+
+// stack monitoring (StackMonitor.c): up to STACK_MONITOR_MAX_TASKS tasks are watched, each
+// checked every STACK_SCAN_PERIOD ms, with a warning when one has fewer than STACK_WARN_WORDS
+// words it has never used. STACK_RESERVED_WORDS is how much of the top and bottom of a stack
+// is left unpainted for the kernel's use; STACK_PAINT_GUARD_WORDS is how far below itself
+// the painting stops. On a PC (core/host) there are no warnings: its C library alone uses
+// more stack than a Cortex task has, so the figures only mean something on the robot.
+#define STACK_MONITOR_MAX_TASKS 12
+#define STACK_SCAN_PERIOD 1000
+#ifdef K_HOST
+#define STACK_WARN_WORDS 0
+#else
+#define STACK_WARN_WORDS 64
+#endif
+#define STACK_RESERVED_WORDS 48
+#define STACK_PAINT_GUARD_WORDS 16
+#define STACK_PAINT 0xA5A5A5A5
+
+// deadlines (Deadline.c): DEADLINE_MISS_LIMIT misses in a row take a task's safe action, as
+// does a task being DEADLINE_MISS_LIMIT periods (and at least DEADLINE_STALL_MIN ms) overdue
+// - the watchdog looks every DEADLINE_WATCHDOG_PERIOD ms. The robot stays degraded until
+// nothing has missed for DEADLINE_RECOVERY ms.
+#define DEADLINE_MAX 12
+#define DEADLINE_MISS_LIMIT 3
+#define DEADLINE_RECOVERY 2000
+#define DEADLINE_WATCHDOG_PERIOD 5
+#define DEADLINE_STALL_MIN 20
+#define DEADLINE_ACTION_SHED 0 // skip optional work (LCD, telemetry)
+#define DEADLINE_ACTION_STOP 1 // that, and hold every motor at 0 until the robot recovers
+
+// object pools (Arena.c): at most POOL_MAX of them, all carved from the arena.
+#define POOL_MAX 8
+
+// characters on one line of the LCD
+#define LCD_LINE_LENGTH 16
+
+// CPU profiling (Profiler.c): up to PROFILE_MAX_SECTIONS timed sections; shares are worked
+// out over windows of PROFILE_WINDOW ms.
+#define PROFILE_MAX_SECTIONS 12
+#define PROFILE_WINDOW 1000
+
+// the sensor registry (SensorRegistry.c): up to SENSOR_MAX sensors, checked every
+// SENSOR_TICK_PERIOD ms to see which are due (so every period in a K_SENSORS() list should be
+// a multiple of it).
+#define SENSOR_MAX 16
+#define SENSOR_TICK_PERIOD 5
+
+// the kinds of sensor the registry reads itself. A project numbers its own kinds from
+// SENSOR_TYPE_ROBOT up, and reads them in the SensorReader it gives sensorRegistryInit().
+#define SENSOR_TYPE_ANALOG 0     // 0-4095, from analogRead(); port is 1-8
+#define SENSOR_TYPE_DIGITAL 1    // 0 or 1; port is 1-12
+#define SENSOR_TYPE_ULTRASONIC 2 // cm; port is the orange (echo) wire, port2 the yellow
+#define SENSOR_TYPE_BATTERY 3    // main battery, millivolts
+#define SENSOR_TYPE_ROBOT 16
+
+// binary telemetry (Telemetry.c) out of UART 2, at TELEMETRY_BAUD: at most one frame every
+// TELEMETRY_PERIOD ms, up to TELEMETRY_QUEUE_SIZE frames waiting (a power of two), each at
+// most TELEMETRY_FRAME_MAX bytes. The telemetry task checks for frames every
+// TELEMETRY_IDLE_WAIT ms.
+#define TELEMETRY_BAUD 115200
+#define TELEMETRY_PERIOD 10
+#define TELEMETRY_QUEUE_SIZE 16
+#define TELEMETRY_FRAME_MAX 64
+#define TELEMETRY_IDLE_WAIT 5
+
+#include <API.h>
+#include "RingBuffer.h"
+#include "Format.h"
+// Allow usage of this file in C++ programs
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * defines the table K_setMotor() and friends use to turn "positive is forward" into what each
+ * port needs, from PORT_ORIENTATION_1 to PORT_ORIENTATION_10. Use it once per project:
+ *
+ *   K_MOTOR_DIRECTIONS;
+ */
+#define K_MOTOR_DIRECTIONS                                                                  \
+	const int DIRECTION_MODIFIERS[] = {0, /* not actually on cortex. Do not use.. */          \
+	                                   PORT_ORIENTATION_1, PORT_ORIENTATION_2,                \
+	                                   PORT_ORIENTATION_3, PORT_ORIENTATION_4,                \
+	                                   PORT_ORIENTATION_5, PORT_ORIENTATION_6,                \
+	                                   PORT_ORIENTATION_7, PORT_ORIENTATION_8,                \
+	                                   PORT_ORIENTATION_9, PORT_ORIENTATION_10}
+
+extern const int DIRECTION_MODIFIERS[];
+
+/**
+ * defines the arena: size bytes, in the ".arena" section that firmware/cortex.ld puts just
+ * below the kernel heap. Use it once per project, if it uses arenaAlloc() or poolInit():
+ *
+ *   K_ARENA(ARENA_SIZE);
+ *
+ * (On a PC - see core/host - it is an ordinary array, since not every PC's linker takes
+ * section names like that.)
+ */
+#ifdef K_HOST
+#define K_ARENA_SECTION
+#else
+#define K_ARENA_SECTION section(".arena"),
+#endif
+#define K_ARENA(size)                                                                       \
+	unsigned char kArena[size] __attribute__((K_ARENA_SECTION aligned(8)));                 \
+	const size_t kArenaSize = (size)
+
+extern unsigned char kArena[];
+extern const size_t kArenaSize;
+
+/**
+ * a fixed number of same-sized objects, set up by poolInit() (Arena.c). One task may take
+ * objects with poolAlloc(), and one task may give them back with poolFree().
+ */
+typedef struct {
+	const char *name;
+	unsigned char *objects;
+	size_t objectSize;     // rounded up to a multiple of 8 bytes
+	unsigned int capacity;
+	unsigned int *freeList; // a ring of the numbers of the free objects
+	RingIndex head;         // next free-list slot poolFree() fills
+	RingIndex tail;         // next free-list slot poolAlloc() empties
+	unsigned int lowWater;  // fewest objects that have ever been free
+	unsigned int failures;  // poolAlloc() calls that found none free
+} ObjectPool;
+
+/**
+ * how to read one sensor: one entry of a project's K_SENSORS() list.
+ */
+typedef struct {
+	const char *name;
+	int type;                  // SENSOR_TYPE_...
+	unsigned char port;
+	unsigned char port2;       // second port, for sensors with two wires (ultrasonic)
+	unsigned long period;      // ms between readings
+} SensorConfig;
+
+/**
+ * defines the table of every sensor the registry reads, from an X-macro list whose entries
+ * are X(name, SENSOR_TYPE_..., port, port2, how often to read it in ms). Use it once per
+ * project, if it uses the sensor registry:
+ *
+ *   K_SENSORS(SENSOR_LIST);
+ *
+ * The project numbers the same list for itself (SENSOR_<name>, in list order), to look its
+ * sensors up in a SensorSnapshot.
+ */
+#define K_SENSOR_CONFIG(name, type, port, port2, period) {#name, type, port, port2, period},
+#define K_SENSORS(list)                                                                     \
+	const SensorConfig kSensors[] = {list(K_SENSOR_CONFIG)};                                \
+	const int kSensorCount = sizeof(kSensors) / sizeof(kSensors[0]);                        \
+	_Static_assert(sizeof(kSensors) / sizeof(kSensors[0]) <= SENSOR_MAX,                    \
+	               "more sensors than SENSOR_MAX")
+
+extern const SensorConfig kSensors[];
+extern const int kSensorCount;
+
+/**
+ * one sensor's value, and the millis() time it was read.
+ */
+typedef struct {
+	int value;
+	unsigned long timestamp;
+} SensorValue;
+
+/**
+ * every sensor's latest value, as published together by the sensor registry. Use the
+ * project's SENSOR_... ids to index reading[].
+ */
+typedef struct {
+	unsigned long cycle;     // goes up by one with each snapshot
+	unsigned long timestamp; // millis() when the snapshot was published
+	SensorValue reading[SENSOR_MAX];
+} SensorSnapshot;
+
+/**
+ * what the sensor registry calls to read a sensor of one of the project's own types
+ * (SENSOR_TYPE_ROBOT and up). Sets *value and returns true, or returns false if the sensor
+ * couldn't be read (the old value is kept).
+ */
+typedef bool (*SensorReader)(const SensorConfig *sensor, int *value);
+
+/**
+ * names the type of the frames telemetry sends - the project's own layout, which
+ * tools/telemetry.py also reads. Use it once per project, if it uses telemetry:
+ *
+ *   K_TELEMETRY(TelemetryFrame);
+ */
+#define K_TELEMETRY(type)                                                                   \
+	const size_t kTelemetryFrameSize = sizeof(type);                                        \
+	_Static_assert(sizeof(type) <= TELEMETRY_FRAME_MAX, "frames bigger than TELEMETRY_FRAME_MAX")
+
+extern const size_t kTelemetryFrameSize;
+
+/**
+ * what telemetryBegin() says about the frame it hands out, for the project to copy into it.
+ */
+typedef struct {
+	unsigned short sequence; // goes up by one each frame, so gaps show lost frames
+	unsigned long time_us;   // micros() when the frame was handed out
+	unsigned long cycle_us;  // time since the previous frame
+	bool dropped;            // frames were lost just before this one (or the robot was
+	                         // degraded, and sent none)
+} TelemetryStamp;
+
+/**
+ * what deadlineOnTrip() calls when a deadline trips: the id deadlineRegister() gave it.
+ */
+typedef void (*DeadlineTripHandler)(int id);
+
+// -------------------------  Methods in Motors.c --------------------------
+/**
+ *  turns on the given motor at the current power level - just like motorSet, but incorporates
+ *  DIRECTION_MODIFIERS so we can assume positive is always forward. While the motors are
+ *  held (K_holdMotors()), it sets 0 instead.
+ */
+void K_setMotor(int whichPort, int power);
+
+/**
+ * stops every motor and keeps K_setMotor() from starting them again (hold true), or lets it
+ * (hold false). The deadlines use this when a task driving the motors can't keep up.
+ */
+void K_holdMotors(bool hold);
+
+/**
+ * true while K_holdMotors() is keeping the motors stopped.
+ */
+bool K_motorsHeld();
+
+/*
+ * determines the current setting for thie given motor, -128 <-> + 128. Based on the
+ * DIRECTION_MODIFIERS, so it is compatible with K_setMotor.
+ */
+int K_getMotor(int whichPort);
+
+/**
+ * sets the motor to power level 1 or -1, so the motor is free to rotate (as opposed to 0,
+ * which puts on the brakes). If the motor is already set to zero, it stays at zero.
+ */
+void K_floatMotor(int whichPort);
+
+/**
+ * stops the motor - puts the brakes on it. Probably not a good idea if you are at top speed
+ * and wish to slow down.
+ */
+void K_stopMotor(int whichPort);
+
+/**
+ * shapes a power from a joystick or a drive mix: limits it to -127 to +127, and makes
+ * anything closer to 0 than deadband exactly 0, so the motors don't drift.
+ */
+int K_shapePower(int power, int deadband);
+
+// -------------------------  Methods in Checksum.c --------------------------
+/**
+ * works out the CRC-16/CCITT of "length" bytes at "data". To checksum something in pieces,
+ * pass the result for the first piece as the "crc" of the next; start with CRC16_INITIAL.
+ */
+unsigned short crc16(const void *data, size_t length, unsigned short crc);
+
+// -------------------------  Methods in Cobs.c --------------------------
+/**
+ * COBS-encodes "length" bytes at "in" into "out", which must have room for length +
+ * length / 254 + 1 bytes. The result has no zero bytes in it, so a zero byte can mark the end
+ * of a frame. Returns the encoded length.
+ */
+size_t cobsEncode(const unsigned char *in, size_t length, unsigned char *out);
+
+// -------------------------  Methods in StackMonitor.c --------------------------
+/**
+ * just like taskCreate(), but the task's stack use is watched (and reported under "name").
+ * If too many tasks are already watched, the task is still started, just not watched.
+ */
+TaskHandle taskCreateMonitored(const char *name, TaskCode taskCode,
+                               const unsigned int stackDepth, void *parameters,
+                               const unsigned int priority);
+
+/**
+ * watches the stack of the task that calls this, which the kernel started with stackDepth
+ * words of stack. For operatorControl() and autonomous(); call it first thing. Calling it
+ * again when the task is restarted paints the new stack.
+ */
+void stackMonitorRegisterCurrent(const char *name, unsigned int stackDepth);
+
+/**
+ * starts the task that checks every watched stack. Call once, from initialize().
+ */
+void stackMonitorInit();
+
+/**
+ * prints each watched task's stack size and the most it has used. "Used" counts the words
+ * the monitor can't check, so the real figure is up to STACK_RESERVED_WORDS lower.
+ */
+void stackReport(PROS_FILE *stream);
+
+// -------------------------  Methods in Profiler.c --------------------------
+/**
+ * finds the section called name, or adds it. Returns its id, or -1 if there are already
+ * PROFILE_MAX_SECTIONS sections (profileStart() and profileStop() ignore -1).
+ */
+int profileRegister(const char *name);
+
+/**
+ * the section "id" is starting. Each section must only be timed by one task.
+ */
+void profileStart(int id);
+
+/**
+ * the section "id" has finished.
+ */
+void profileStop(int id);
+
+/**
+ * starts the profiler and the idle sampler. Call once, from initialize().
+ */
+void profilerInit();
+
+/**
+ * prints every section's share of the last window, busiest first, then idle and the rest.
+ */
+void profileReport(PROS_FILE *stream);
+
+/**
+ * shows idle time and the busiest section on the LCD, on the given line and the next.
+ */
+void profileShowOnLCD(unsigned char line);
+
+// -------------------------  Methods in Deadline.c --------------------------
+/**
+ * finds the deadline called name, or adds it, with the given safe action
+ * (DEADLINE_ACTION_...). Returns its id, or -1 if there are already DEADLINE_MAX - in which
+ * case deadlineWait() still waits, but nothing is checked.
+ */
+int deadlineRegister(const char *name, int action);
+
+/**
+ * ends one cycle of a periodic task: checks whether this cycle ran late, then waits for the
+ * start of the next one, period ms after the start of this one. Use it like taskDelayUntil():
+ * set *wakeTime = millis() before the task's loop, and pass the same variable every time.
+ */
+void deadlineWait(int id, unsigned long *wakeTime, unsigned long period);
+
+/**
+ * has handler called whenever a deadline trips, after its safe action has been taken - e.g.
+ * to note it in a log. It is called from the task that missed, or from the watchdog if the
+ * task stalled, so it must be quick and safe to call from any task. Only one handler; NULL for
+ * none.
+ */
+void deadlineOnTrip(DeadlineTripHandler handler);
+
+/**
+ * starts the watchdog that catches tasks that stall before they get to deadlineWait(). Call
+ * once, from initialize().
+ */
+void deadlineInit();
+
+/**
+ * true while the robot is in degraded mode, because some task hasn't been keeping up. Skip
+ * anything optional (LCD updates, telemetry) while it is.
+ */
+bool deadlineDegraded();
+
+/**
+ * prints every deadline's misses, trips and stalls, and whether the robot is degraded.
+ */
+void deadlineReport(PROS_FILE *stream);
+
+// -------------------------  Methods in SensorRegistry.c --------------------------
+/**
+ * sets up the sensors that need it, takes a first snapshot, and starts the registry task.
+ * reader reads the project's own SENSOR_TYPE_ROBOT... sensors (NULL if it has none). Call
+ * from initialize() after whatever those readings come from is started, and after
+ * stackMonitorInit(), profilerInit() and deadlineInit(): the registry task is watched, timed
+ * and kept to its deadline by all three.
+ */
+void sensorRegistryInit(SensorReader reader);
+
+/**
+ * copies the latest snapshot of every sensor. Call once per cycle and use the copy for the
+ * whole cycle. Never waits for the registry task.
+ */
+void sensorSnapshotGet(SensorSnapshot *copy);
+
+/**
+ * prints every sensor's latest value and age.
+ */
+void sensorReport(PROS_FILE *stream);
+
+// -------------------------  Methods in Telemetry.c --------------------------
+/**
+ * a blank frame for the drive loop to fill in, or NULL if no frame is due: frames are sent
+ * at most every TELEMETRY_PERIOD ms, and none while the robot is degraded or the queue is
+ * full. stamp is filled in with the frame's sequence number and timing. Call once per cycle
+ * from the loop that drives the motors (and only that loop), and hand the frame to
+ * telemetryCommit(). Takes a few microseconds, and never waits.
+ */
+void *telemetryBegin(TelemetryStamp *stamp);
+
+/**
+ * queues a frame from telemetryBegin(), once it is filled in, to be sent.
+ */
+void telemetryCommit(void *frame);
+
+/**
+ * sets up the frame pool and starts the telemetry task. Call once, from initialize(); UART 2
+ * must already be open at TELEMETRY_BAUD (see initializeIO()).
+ */
+void telemetryInit();
+
+/**
+ * prints how many frames have been sent and dropped.
+ */
+void telemetryReport(PROS_FILE *stream);
+
+// -------------------------  Methods in Arena.c --------------------------
+/**
+ * sets aside size bytes of the arena (8-byte aligned, filled with zeros) for good. Returns
+ * NULL if there isn't enough left; make the project's K_ARENA() bigger if that happens.
+ */
+void *arenaAlloc(size_t size);
+
+/**
+ * sets up a pool of "capacity" objects, each objectSize bytes, taken from the arena.
+ * capacity must be a power of two. Returns false if the arena is too full (or capacity
+ * isn't a power of two), in which case poolAlloc() always fails.
+ */
+bool poolInit(ObjectPool *pool, const char *name, size_t objectSize, unsigned int capacity);
+
+/**
+ * takes an object from the pool. Returns NULL if they are all in use. Only one task may take
+ * objects from a pool.
+ */
+void *poolAlloc(ObjectPool *pool);
+
+/**
+ * gives an object back to the pool it came from. Only one task may give objects back to a
+ * pool (it may be the same one that takes them).
+ */
+void poolFree(ObjectPool *pool, void *object);
+
+/**
+ * how many objects in the pool are in use right now.
+ */
+unsigned int poolInUse(ObjectPool *pool);
+
+/**
+ * prints how much of the arena is used, and each pool's use now and at worst.
+ */
+void memoryReport(PROS_FILE *stream);
+
+// End C++ export structure
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/** @file Arena.c
+ * @brief Memory that is set aside once, instead of malloc()
+ *
+ * malloc() takes from the same heap as the kernel's task stacks, can take a while, and on
+ * a 64 KB processor a heap that gets broken into pieces can fail in the middle of a match.
+ * So nothing here ever gives memory back to the heap:
+ *
+ *  - the arena is set aside by the project, with K_ARENA() (kcore.h), in its own ".arena"
+ *    section that firmware/cortex.ld puts just below the kernel heap. arenaAlloc() hands
+ *    out pieces of it, one after another, and they are never freed - it is for things set up
+ *    once, in initialize().
+ *  - an ObjectPool is a fixed number of same-sized objects carved from the arena. poolAlloc()
+ *    and poolFree() take and return them in constant time, without locks, for things that
+ *    come and go while the robot runs (log records, telemetry frames, routine steps). The
+ *    free objects are kept in a ring (like RingBuffer.h), so one task may take objects and one
+ *    task may give them back.
+ *
+ * "memory" on the console shows how much of each is in use, and the most that ever was.
+ */
+
+#include "kcore.h"
+#include <string.h>
+
+static volatile size_t arenaUsed = 0;
+static unsigned int arenaFailures = 0;
+
+// every pool, for the report.
+static ObjectPool *pools[POOL_MAX];
+static volatile int numPools = 0;
+
+/**
+ * sets aside size bytes of the arena (8-byte aligned, filled with zeros) for good. Returns
+ * NULL if there isn't enough left; make the project's K_ARENA() bigger if that happens.
+ */
+void *arenaAlloc(size_t size)
+{
+	size_t used;
+	size_t next;
+	do
+	{
+		used = arenaUsed;
+		next = used + ((size + 7) & ~(size_t)7);
+		if (next > kArenaSize || next < used)
+		{
+			arenaFailures++;
+			return NULL;
+		}
+		// (in case two tasks ask at once: only take the space if nobody else just did.)
+	} while (!__sync_bool_compare_and_swap(&arenaUsed, used, next));
+
+	memset(&kArena[used], 0, next - used);
+	return &kArena[used];
+}
+
+/**
+ * sets up a pool of "capacity" objects, each objectSize bytes, taken from the arena.
+ * capacity must be a power of two. Returns false if the arena is too full (or capacity
+ * isn't a power of two), in which case poolAlloc() always fails.
+ */
+bool poolInit(ObjectPool *pool, const char *name, size_t objectSize, unsigned int capacity)
+{
+	memset(pool, 0, sizeof(*pool));
+	pool->name = name;
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+		return false;
+
+	pool->objectSize = (objectSize + 7) & ~(size_t)7;
+	pool->objects = arenaAlloc(pool->objectSize * capacity);
+	pool->freeList = arenaAlloc(capacity * sizeof(pool->freeList[0]));
+	if (pool->objects == NULL || pool->freeList == NULL)
+		return false;
+
+	// every object starts out free.
+	for (unsigned int i = 0; i < capacity; i++)
+		pool->freeList[i] = i;
+	pool->capacity = capacity;
+	pool->lowWater = capacity;
+	ringStoreRelease(&pool->tail, 0);
+	ringStoreRelease(&pool->head, capacity);
+
+	if (numPools < POOL_MAX)
+		pools[numPools++] = pool;
+	return true;
+}
+
+/**
+ * takes an object from the pool. Returns NULL if they are all in use. Only one task may take
+ * objects from a pool.
+ */
+void *poolAlloc(ObjectPool *pool)
+{
+	unsigned int tail = ringLoadAcquire(&pool->tail);
+	unsigned int available = ringLoadAcquire(&pool->head) - tail;
+	if (available == 0)
+	{
+		pool->failures++;
+		return NULL;
+	}
+	if (available - 1 < pool->lowWater)
+		pool->lowWater = available - 1;
+
+	unsigned int id = pool->freeList[tail % pool->capacity];
+	ringStoreRelease(&pool->tail, tail + 1);
+	return pool->objects + id * pool->objectSize;
+}
+
+/**
+ * gives an object back to the pool it came from. Only one task may give objects back to a
+ * pool (it may be the same one that takes them).
+ */
+void poolFree(ObjectPool *pool, void *object)
+{
+	unsigned int head = ringLoadAcquire(&pool->head);
+	unsigned int id = ((unsigned char *)object - pool->objects) / pool->objectSize;
+	pool->freeList[head % pool->capacity] = id;
+	ringStoreRelease(&pool->head, head + 1);
+}
+
+/**
+ * how many objects in the pool are in use right now.
+ */
+unsigned int poolInUse(ObjectPool *pool)
+{
+	return pool->capacity - (ringLoadAcquire(&pool->head) - ringLoadAcquire(&pool->tail));
+}
+
+/**
+ * prints how much of the arena is used, and each pool's use now and at worst.
+ */
+void memoryReport(PROS_FILE *stream)
+{
+	fprintf(stream, "arena: %u of %u bytes used", (unsigned int)arenaUsed,
+	        (unsigned int)kArenaSize);
+	if (arenaFailures > 0)
+		fprintf(stream, ", %u requests REFUSED", arenaFailures);
+	fprintf(stream, "\r\n");
+	for (int i = 0; i < numPools; i++)
+	{
+		ObjectPool *pool = pools[i];
+		fprintf(stream, "  %-10s %u x %u bytes: %u in use, most ever %u, %u refused\r\n",
+		        pool->name, pool->capacity, (unsigned int)pool->objectSize, poolInUse(pool),
+		        pool->capacity - pool->lowWater, pool->failures);
+	}
+}
@@ -0,0 +1,26 @@
+/** @file Checksum.c
+ * @brief CRC used to make sure data saved to flash (or sent over serial) arrived intact
+ */
+
+#include "kcore.h"
+
+/**
+ * works out the CRC-16/CCITT of "length" bytes at "data". To checksum something in pieces,
+ * pass the result for the first piece as the "crc" of the next; start with CRC16_INITIAL.
+ */
+unsigned short crc16(const void *data, size_t length, unsigned short crc)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	while (length-- > 0)
+	{
+		crc ^= (unsigned short)(*bytes++) << 8;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			if (crc & 0x8000)
+				crc = (crc << 1) ^ 0x1021;
+			else
+				crc <<= 1;
+		}
+	}
+	return crc;
+}
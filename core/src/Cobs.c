@@ -0,0 +1,39 @@
+/** @file Cobs.c
+ * @brief Framing for binary data sent over serial
+ *
+ * COBS (consistent overhead byte stuffing) rewrites a block of bytes so it has no zeros in
+ * it, for at most one extra byte in 254. A zero byte can then mark the end of each frame, so
+ * whoever is listening can find the next frame even after joining partway through or losing
+ * bytes. tools/telemetry.py undoes it.
+ */
+
+#include "kcore.h"
+
+/**
+ * COBS-encodes "length" bytes at "in" into "out", which must have room for length +
+ * length / 254 + 1 bytes. The result has no zero bytes in it, so a zero byte can mark the end
+ * of a frame. Returns the encoded length.
+ */
+size_t cobsEncode(const unsigned char *in, size_t length, unsigned char *out)
+{
+	size_t codeAt = 0; // where the current block's length byte goes
+	size_t written = 1;
+	unsigned char code = 1;
+	for (size_t i = 0; i < length; i++)
+	{
+		if (in[i] != 0)
+		{
+			out[written++] = in[i];
+			code++;
+		}
+		if (in[i] == 0 || code == 0xFF)
+		{
+			// finish this block: its length byte says how far it is to the next zero.
+			out[codeAt] = code;
+			codeAt = written++;
+			code = 1;
+		}
+	}
+	out[codeAt] = code;
+	return written;
+}
@@ -0,0 +1,254 @@
+/** @file Deadline.c
+ * @brief Notices when a periodic task can't keep up, and does something safe about it
+ *
+ * Each periodic task registers once, and then ends every cycle with deadlineWait() instead
+ * of taskDelayUntil(). If the cycle's work ran past the start of the next period, that is a
+ * "miss": it is counted, and the task starts again from now rather than rushing through the
+ * cycles it missed.
+ *
+ * A task that never gets to deadlineWait() at all - stuck in a slow I2C call, say - can't
+ * count its own misses, so a watchdog task, above every periodic task, checks each one's
+ * heartbeat every DEADLINE_WATCHDOG_PERIOD ms. A task whose cycle should have ended
+ * DEADLINE_MISS_LIMIT periods ago (and at least DEADLINE_STALL_MIN ms ago, so a task with a
+ * very short period isn't caught out by ordinary jitter) is "stalled".
+ *
+ * DEADLINE_MISS_LIMIT misses in a row from one task, or a stall, trip its safe action:
+ *  - DEADLINE_ACTION_SHED puts the robot in "degraded" mode, where optional work (the LCD,
+ *    telemetry) is skipped so the important tasks get their time back;
+ *  - DEADLINE_ACTION_STOP does that too, and stops every motor - and keeps them stopped
+ *    with K_holdMotors() (Motors.c) until the robot recovers, so the task can't carry on
+ *    with a stale command the moment it catches up.
+ * The robot leaves degraded mode once nothing has missed more than once in a row, and nothing
+ * is stalled, for DEADLINE_RECOVERY ms.
+ *
+ * When the competition mode changes, the kernel stops autonomous() or operatorControl(); a
+ * deadline whose task hasn't checked in since the mode changed may simply be gone, so the
+ * watchdog leaves it alone until the task checks in again.
+ */
+
+#include "kcore.h"
+#include <string.h>
+
+/**
+ * one periodic task's deadline, and how well it has kept to it.
+ */
+typedef struct {
+	const char *name;
+	unsigned long period;        // ms, as last passed to deadlineWait()
+	int action;                  // DEADLINE_ACTION_...
+	unsigned long cycles;
+	unsigned long misses;
+	unsigned int missesInARow;
+	unsigned long worstLateness; // ms
+	unsigned long trips;         // times the safe action has been taken for misses
+	// the heartbeat, written by the task in deadlineWait(): when the cycle it is about to
+	// start should be finished, and the competition mode it was in. Nothing is checked until
+	// armed.
+	volatile unsigned long due;
+	volatile int mode;
+	volatile bool armed;
+	// the watchdog's side: whether it has found the task stalled (until the task next checks
+	// in), and how many times it has.
+	volatile bool stalled;
+	unsigned long stalls;
+} Deadline;
+
+static Deadline deadlines[DEADLINE_MAX];
+static volatile int numDeadlines = 0;
+
+// millis() when anything last tripped its safe action, stalled, or missed twice or more in a
+// row while degraded (a single miss now and then is only jitter, and mustn't keep the robot
+// degraded for good).
+static volatile unsigned long lastTrouble = 0;
+static volatile bool degraded = false;
+
+// called whenever a deadline trips (see deadlineOnTrip()), or NULL.
+static DeadlineTripHandler tripHandler = NULL;
+
+/**
+ * the competition mode right now, as a number that changes whenever it does.
+ */
+static int competitionMode()
+{
+	return (isEnabled() ? 1 : 0) | (isAutonomous() ? 2 : 0);
+}
+
+/**
+ * finds the deadline called name, or adds it, with the given safe action
+ * (DEADLINE_ACTION_...). Returns its id, or -1 if there are already DEADLINE_MAX - in which
+ * case deadlineWait() still waits, but nothing is checked.
+ */
+int deadlineRegister(const char *name, int action)
+{
+	int id;
+	for (id = 0; id < numDeadlines; id++)
+		if (strcmp(deadlines[id].name, name) == 0)
+			break;
+	if (id == numDeadlines)
+	{
+		if (numDeadlines >= DEADLINE_MAX)
+			return -1;
+		deadlines[id].name = name;
+		numDeadlines++;
+	}
+	// (a task started again - operatorControl() after a disable, say - registers again; its
+	// old heartbeat means nothing until it checks in.)
+	deadlines[id].armed = false;
+	deadlines[id].stalled = false;
+	deadlines[id].action = action;
+	deadlines[id].missesInARow = 0;
+	return id;
+}
+
+/**
+ * takes a deadline's safe action, after too many misses in a row or a stall.
+ */
+static void trip(Deadline *deadline)
+{
+	if (deadline->action == DEADLINE_ACTION_STOP)
+		K_holdMotors(true);
+	lastTrouble = millis();
+	degraded = true;
+	if (tripHandler != NULL)
+		tripHandler(deadline - deadlines);
+}
+
+/**
+ * has handler called whenever a deadline trips, after its safe action has been taken - e.g.
+ * to note it in a log. It is called from the task that missed, or from the watchdog if the
+ * task stalled, so it must be quick and safe to call from any task. Only one handler; NULL for
+ * none.
+ */
+void deadlineOnTrip(DeadlineTripHandler handler)
+{
+	tripHandler = handler;
+}
+
+/**
+ * ends one cycle of a periodic task: checks whether this cycle ran late, then waits for the
+ * start of the next one, period ms after the start of this one. Use it like taskDelayUntil():
+ * set *wakeTime = millis() before the task's loop, and pass the same variable every time.
+ */
+void deadlineWait(int id, unsigned long *wakeTime, unsigned long period)
+{
+	if (id < 0)
+	{
+		taskDelayUntil(wakeTime, period);
+		return;
+	}
+	Deadline *deadline = &deadlines[id];
+	unsigned long now = millis();
+	unsigned long late = now - (*wakeTime + period);
+	deadline->period = period;
+	deadline->cycles++;
+
+	// (signed, so a cycle that finished early - "negative lateness" - isn't a miss.)
+	bool missed = (long)late > 0;
+	if (missed)
+	{
+		deadline->misses++;
+		if (late > deadline->worstLateness)
+			deadline->worstLateness = late;
+		// start again from now, instead of racing through the cycles we missed.
+		*wakeTime = now;
+	}
+
+	// the heartbeat: the next cycle starts period ms after *wakeTime, and should be done
+	// another period after that. Written before looking at "stalled", so the watchdog can't
+	// find the task stalled again on the old one.
+	deadline->mode = competitionMode();
+	deadline->due = *wakeTime + 2 * period;
+	deadline->armed = true;
+	bool wasStalled = deadline->stalled;
+	deadline->stalled = false;
+
+	if (!missed || wasStalled)
+		// (back from a stall the watchdog has already tripped on: that was one long miss.)
+		deadline->missesInARow = 0;
+	else if (++deadline->missesInARow >= DEADLINE_MISS_LIMIT)
+	{
+		deadline->trips++;
+		deadline->missesInARow = 0;
+		trip(deadline);
+	}
+	else if (deadline->missesInARow > 1 && degraded)
+		lastTrouble = now;
+
+	taskDelayUntil(wakeTime, period);
+}
+
+/**
+ * the watchdog: every DEADLINE_WATCHDOG_PERIOD ms, trips any deadline whose task has
+ * stalled, keeps the robot degraded while one is, and lets it recover once none is.
+ */
+static void watchdogTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	while (true)
+	{
+		unsigned long now = millis();
+		int mode = competitionMode();
+		for (int id = 0; id < numDeadlines; id++)
+		{
+			Deadline *deadline = &deadlines[id];
+			if (!deadline->armed || deadline->mode != mode)
+				continue;
+			long overdue = (long)(now - deadline->due);
+			long limit = deadline->period * DEADLINE_MISS_LIMIT;
+			if (overdue <= (limit > DEADLINE_STALL_MIN ? limit : DEADLINE_STALL_MIN))
+				continue;
+			if (!deadline->stalled)
+			{
+				deadline->stalled = true;
+				deadline->stalls++;
+				trip(deadline);
+			}
+			lastTrouble = now; // it isn't over until the task checks in again
+		}
+		deadlineDegraded(); // (recovers, if it is time)
+		taskDelayUntil(&wakeTime, DEADLINE_WATCHDOG_PERIOD);
+	}
+}
+
+/**
+ * starts the watchdog that catches tasks that stall before they get to deadlineWait(). Call
+ * once, from initialize().
+ */
+void deadlineInit()
+{
+	taskCreateMonitored("watchdog", watchdogTask, TASK_MINIMAL_STACK_SIZE * 2, NULL,
+	                    TASK_PRIORITY_HIGHEST - 1);
+}
+
+/**
+ * true while the robot is in degraded mode, because some task hasn't been keeping up. Skip
+ * anything optional (LCD updates, telemetry) while it is.
+ */
+bool deadlineDegraded()
+{
+	if (degraded && millis() - lastTrouble > DEADLINE_RECOVERY)
+	{
+		degraded = false;
+		if (K_motorsHeld())
+			K_holdMotors(false);
+	}
+	return degraded;
+}
+
+/**
+ * prints every deadline's misses, trips and stalls, and whether the robot is degraded.
+ */
+void deadlineReport(PROS_FILE *stream)
+{
+	fprintf(stream, "%s\r\n", !deadlineDegraded() ? "all tasks keeping up" :
+	                          K_motorsHeld() ? "DEGRADED - motors held at 0" :
+	                                           "DEGRADED - shedding optional work");
+	for (int id = 0; id < numDeadlines; id++)
+	{
+		const Deadline *deadline = &deadlines[id];
+		fprintf(stream, "%-10s every %3lu ms: %lu cycles, %lu missed (worst %lu ms late), "
+		        "%lu trips, %lu stalls%s\r\n", deadline->name, deadline->period,
+		        deadline->cycles, deadline->misses, deadline->worstLateness, deadline->trips,
+		        deadline->stalls, deadline->stalled ? " - STALLED NOW" : "");
+	}
+}
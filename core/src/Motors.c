@@ -0,0 +1,92 @@
+/** @file Motors.c
+ * @brief The motor layer every robot drives through
+ *
+ * motorSet() takes whatever power the port is wired for, so half the motors on a drive go
+ * backwards for "forward". K_setMotor() and the rest look each port up in
+ * DIRECTION_MODIFIERS (which the project defines with K_MOTOR_DIRECTIONS, from its
+ * PORT_ORIENTATION_n) so the code above them can take positive as forward everywhere.
+ */
+
+#include "kcore.h"
+
+// set by K_holdMotors(); while it is, K_setMotor() only ever sets 0.
+static volatile bool held = false;
+
+/**
+ *  turns on the given motor at the current power level - just like motorSet, but incorporates
+ *  DIRECTION_MODIFIERS so we can assume positive is always forward. While the motors are
+ *  held (K_holdMotors()), it sets 0 instead.
+ */
+void K_setMotor(int whichPort, int power)
+{
+	if (held)
+		power = 0;
+	motorSet(whichPort, power*DIRECTION_MODIFIERS[whichPort]);
+}
+
+/*
+ * determines the current setting for thie given motor, -128 <-> + 128. Based on the
+ * DIRECTION_MODIFIERS, so it is compatible with K_setMotor.
+ */
+int K_getMotor(int whichPort)
+{
+	return motorGet(whichPort)*DIRECTION_MODIFIERS[whichPort];
+}
+
+/**
+ * stops every motor and keeps K_setMotor() from starting them again (hold true), or lets it
+ * (hold false). The deadlines use this when a task driving the motors can't keep up.
+ */
+void K_holdMotors(bool hold)
+{
+	held = hold;
+	if (hold)
+		motorStopAll();
+}
+
+/**
+ * true while K_holdMotors() is keeping the motors stopped.
+ */
+bool K_motorsHeld()
+{
+	return held;
+}
+
+/**
+ * sets the motor to power level 1 or -1, so the motor is free to rotate (as opposed to 0,
+ * which puts on the brakes). If the motor is already set to zero, it stays at zero.
+ */
+void K_floatMotor(int whichPort)
+{
+	int current_level = motorGet(whichPort);
+	if (current_level == 0)
+		return;
+	if (current_level < 0)
+		motorSet(whichPort,-1);
+	else
+		motorSet(whichPort, 1);
+}
+
+/**
+ * stops the motor - puts the brakes on it. Probably not a good idea if you are at top speed
+ * and wish to slow down.
+ */
+void K_stopMotor(int whichPort)
+{
+	motorSet(whichPort,0);
+}
+
+/**
+ * shapes a power from a joystick or a drive mix: limits it to -127 to +127, and makes
+ * anything closer to 0 than deadband exactly 0, so the motors don't drift.
+ */
+int K_shapePower(int power, int deadband)
+{
+	if (power > 127)
+		return 127;
+	if (power < -127)
+		return -127;
+	if (power < deadband && power > -deadband)
+		return 0;
+	return power;
+}
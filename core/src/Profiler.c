@@ -0,0 +1,234 @@
+/** @file Profiler.c
+ * @brief How much of the processor each task is using
+ *
+ * The kernel doesn't tell us when it switches tasks, so each task's loop times its own work
+ * instead: profileStart(id) before it, profileStop(id) after. If a higher-priority task
+ * takes over in between, that task's (also timed) work would be counted twice, so every
+ * section adds its time to a shared total as well, and profileStop() takes away whatever
+ * the shared total grew by while it was running. That leaves each section with only its
+ * own time.
+ *
+ * Idle time is sampled once a kernel tick, without a task that spins (one at the lowest
+ * priority would share the processor with the kernel's own idle task, which frees the memory
+ * of deleted tasks). The sampler sits just above the idle task and wakes on every tick: it
+ * only gets the processor once everything else that woke on that tick has finished, so how
+ * late it is, in microseconds, is how busy that tick was; the rest of the tick was idle. Then
+ * it sleeps until the next tick. Most of our work is started by the tick (taskDelayUntil()),
+ * but anything that starts part-way through a tick, after the sampler has run (a task woken
+ * by a serial byte, say), counts as idle - so take the figure as "at most this idle".
+ *
+ * Once every PROFILE_WINDOW ms the profiler works out what share of the last window each
+ * section, idle time and everything else (the kernel, interrupts, untimed code) had.
+ */
+
+#include "kcore.h"
+#include <string.h>
+
+/**
+ * one timed section of code.
+ */
+typedef struct {
+	const char *name;
+	unsigned long started;          // micros() at profileStart()
+	unsigned long accountedAtStart; // the shared total at profileStart()
+	volatile unsigned long total;   // microseconds of its own work, ever (rolls over)
+	unsigned long lastTotal;        // the profiler task's copy of total at the last window
+} ProfileSection;
+
+/**
+ * what share of the last window (in tenths of a percent) each section used.
+ */
+typedef struct {
+	int numSections;
+	int permille[PROFILE_MAX_SECTIONS];
+	int idle;
+	int other; // the kernel, interrupts and code outside any section
+} ProfileWindow;
+
+static ProfileSection sections[PROFILE_MAX_SECTIONS];
+static volatile int numSections = 0;
+
+// microseconds of work timed by every section together, ever (rolls over).
+static volatile unsigned long accounted = 0;
+
+// microseconds in a kernel tick (millis() goes up by one each tick)
+#define TICK_US 1000
+
+// microseconds of ticks the idle sampler found busy, ever (rolls over).
+static volatile unsigned long busyTotal = 0;
+
+MAILBOX_DECLARE(WindowMailbox, ProfileWindow)
+static WindowMailbox window;
+
+/**
+ * finds the section called name, or adds it. Returns its id, or -1 if there are already
+ * PROFILE_MAX_SECTIONS sections (profileStart() and profileStop() ignore -1).
+ */
+int profileRegister(const char *name)
+{
+	for (int id = 0; id < numSections; id++)
+		if (strcmp(sections[id].name, name) == 0)
+			return id;
+	if (numSections >= PROFILE_MAX_SECTIONS)
+		return -1;
+	sections[numSections].name = name;
+	return numSections++;
+}
+
+/**
+ * the section "id" is starting. Each section must only be timed by one task.
+ */
+void profileStart(int id)
+{
+	if (id < 0)
+		return;
+	sections[id].accountedAtStart = accounted;
+	sections[id].started = micros();
+}
+
+/**
+ * the section "id" has finished.
+ */
+void profileStop(int id)
+{
+	if (id < 0)
+		return;
+	ProfileSection *section = &sections[id];
+	unsigned long elapsed = micros() - section->started;
+	unsigned long preempted = accounted - section->accountedAtStart;
+	unsigned long own = elapsed > preempted ? elapsed - preempted : 0;
+	section->total += own;
+	// sections in different tasks add to this; an atomic add keeps a preempted one's update.
+	__sync_fetch_and_add(&accounted, own);
+}
+
+/**
+ * the idle sampler: once a tick, counts how long everything above it kept it waiting.
+ */
+static void idleSamplerTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	// micros() doesn't count from the same moment as the tick, so the least lateness ever
+	// seen - a tick nothing else wanted - stands for "on time".
+	long onTime = 0x7FFFFFFF;
+	while (true)
+	{
+		taskDelayUntil(&wakeTime, 1);
+		// (if the sampler itself was kept waiting past the next tick, taskDelayUntil() returns
+		// at once for that one, which is then found busy all the way through.)
+		long late = (long)(micros() - wakeTime * TICK_US);
+		if (late < onTime)
+			onTime = late;
+		late -= onTime;
+		busyTotal += late < TICK_US ? late : TICK_US;
+	}
+}
+
+/**
+ * turns a number of microseconds into tenths of a percent of the window.
+ */
+static int toPermille(unsigned long us, unsigned long windowUs)
+{
+	return (int)((unsigned long long)us * 1000 / windowUs);
+}
+
+/**
+ * the profiler task: works out everybody's share once every PROFILE_WINDOW ms.
+ */
+static void profilerTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	unsigned long windowStart = micros();
+	unsigned long lastBusy = busyTotal;
+	while (true)
+	{
+		taskDelayUntil(&wakeTime, PROFILE_WINDOW);
+		unsigned long now = micros();
+		unsigned long windowUs = now - windowStart;
+		windowStart = now;
+
+		ProfileWindow *next = WindowMailboxBegin(&window);
+		int used = 0;
+		next->numSections = numSections;
+		for (int id = 0; id < next->numSections; id++)
+		{
+			unsigned long total = sections[id].total;
+			next->permille[id] = toPermille(total - sections[id].lastTotal, windowUs);
+			sections[id].lastTotal = total;
+			used += next->permille[id];
+		}
+		unsigned long busy = busyTotal;
+		unsigned long busyUs = busy - lastBusy;
+		next->idle = toPermille(busyUs < windowUs ? windowUs - busyUs : 0, windowUs);
+		lastBusy = busy;
+		next->other = 1000 - used - next->idle;
+		if (next->other < 0)
+			next->other = 0; // rounding, or a window that ended mid-section
+		WindowMailboxCommit(&window);
+	}
+}
+
+/**
+ * starts the profiler and the idle sampler. Call once, from initialize().
+ */
+void profilerInit()
+{
+	// above everything it measures, so the windows are all the same length.
+	taskCreateMonitored("profiler", profilerTask, TASK_MINIMAL_STACK_SIZE * 2, NULL,
+	                    TASK_PRIORITY_DEFAULT + 3);
+	// below everything it measures, but above the kernel's idle task.
+	taskCreateMonitored("idle", idleSamplerTask, TASK_MINIMAL_STACK_SIZE * 2, NULL,
+	                    TASK_PRIORITY_LOWEST + 1);
+}
+
+/**
+ * the section that used the most of the last window, or -1 if nothing is timed yet.
+ */
+static int busiest(const ProfileWindow *last)
+{
+	int top = -1;
+	for (int id = 0; id < last->numSections; id++)
+		if (top < 0 || last->permille[id] > last->permille[top])
+			top = id;
+	return top;
+}
+
+/**
+ * prints every section's share of the last window, busiest first, then idle and the rest.
+ */
+void profileReport(PROS_FILE *stream)
+{
+	ProfileWindow last;
+	WindowMailboxRead(&window, &last);
+	fprintf(stream, "CPU use over the last %d ms:\r\n", PROFILE_WINDOW);
+
+	// print the busiest remaining section, then forget it, until none are left.
+	for (int shown = 0; shown < last.numSections; shown++)
+	{
+		int top = busiest(&last);
+		fprintf(stream, "  %-10s %3d.%d%%\r\n", sections[top].name, last.permille[top] / 10,
+		        last.permille[top] % 10);
+		last.permille[top] = -1;
+	}
+	fprintf(stream, "  %-10s %3d.%d%%\r\n", "(other)", last.other / 10, last.other % 10);
+	fprintf(stream, "  %-10s %3d.%d%%\r\n", "(idle)", last.idle / 10, last.idle % 10);
+}
+
+/**
+ * shows idle time and the busiest section on the LCD, on the given line and the next.
+ */
+void profileShowOnLCD(unsigned char line)
+{
+	ProfileWindow last;
+	char text[LCD_LINE_LENGTH + 1];
+	WindowMailboxRead(&window, &last);
+	K_format(text, sizeof(text), K_STR("CPU idle "), K_FIXED(last.idle, 1, 5), K_CHAR('%'));
+	lcdSetText(uart1, line, text);
+	int top = busiest(&last);
+	if (top >= 0)
+	{
+		K_format(text, sizeof(text), K_STR_PAD(sections[top].name, 8), K_CHAR(' '),
+		         K_FIXED(last.permille[top], 1, 5), K_CHAR('%'));
+		lcdSetText(uart1, line + 1, text);
+	}
+}
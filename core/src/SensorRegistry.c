@@ -0,0 +1,157 @@
+/** @file SensorRegistry.c
+ * @brief One place that reads every sensor, on schedule, and hands out consistent snapshots
+ *
+ * Every sensor on the robot is listed once, in the project's K_SENSORS() list, with how
+ * often it should be read. This task reads each one when it is due, stamps it with the time,
+ * and publishes a snapshot of all of them together. Code that needs sensor values calls
+ * sensorSnapshotGet() once per cycle and uses that copy, so:
+ *  - no sensor is read twice in one cycle by two different pieces of code, and
+ *  - everything in one cycle sees the same values, taken at (nearly) the same time.
+ *
+ * The registry reads the sensors any robot might have itself (SENSOR_TYPE_ANALOG and so on);
+ * anything that needs the project's own code - a gyro filter, an encoder's speed - is a type
+ * numbered from SENSOR_TYPE_ROBOT, read by the SensorReader the project passes to
+ * sensorRegistryInit().
+ */
+
+#include "kcore.h"
+
+// ultrasonic sensors need a handle from ultrasonicInit(); other types don't use this.
+static Ultrasonic ultrasonics[SENSOR_MAX];
+
+// when each sensor is next due to be read.
+static unsigned long nextDue[SENSOR_MAX];
+
+// reads the project's own kinds of sensor, or NULL if it has none.
+static SensorReader readRobotSensor;
+
+// the published snapshots.
+MAILBOX_DECLARE(SnapshotMailbox, SensorSnapshot)
+static SnapshotMailbox snapshots;
+
+// the profiler's id for this task's work.
+static int profileId;
+
+// this task's deadline (Deadline.c).
+static int deadlineId;
+
+/**
+ * reads one sensor. Returns false if it couldn't be read (the old value is kept).
+ */
+static bool readSensor(int id, int *value)
+{
+	const SensorConfig *sensor = &kSensors[id];
+	switch (sensor->type)
+	{
+		case SENSOR_TYPE_ANALOG:
+			*value = analogRead(sensor->port);
+			return true;
+		case SENSOR_TYPE_DIGITAL:
+			*value = digitalRead(sensor->port);
+			return true;
+		case SENSOR_TYPE_ULTRASONIC:
+			*value = ultrasonicGet(ultrasonics[id]);
+			return true;
+		case SENSOR_TYPE_BATTERY:
+			*value = powerLevelMain();
+			return true;
+	}
+	return readRobotSensor != NULL && readRobotSensor(sensor, value);
+}
+
+/**
+ * reads every sensor that is due and publishes a new snapshot.
+ */
+static void sampleSensors()
+{
+	const SensorSnapshot *current = SnapshotMailboxCurrent(&snapshots);
+	SensorSnapshot *spare = SnapshotMailboxBegin(&snapshots);
+	unsigned long now = millis();
+
+	*spare = *current;
+	for (int id = 0; id < kSensorCount; id++)
+	{
+		// (signed, so this still works when millis() rolls over.)
+		if ((long)(now - nextDue[id]) < 0)
+			continue;
+		nextDue[id] += kSensors[id].period;
+		if ((long)(now - nextDue[id]) >= 0)
+			nextDue[id] = now + kSensors[id].period; // we fell behind; don't try to catch up.
+
+		int value;
+		if (readSensor(id, &value))
+		{
+			spare->reading[id].value = value;
+			spare->reading[id].timestamp = now;
+		}
+	}
+	spare->cycle = current->cycle + 1;
+	spare->timestamp = now;
+	SnapshotMailboxCommit(&snapshots);
+}
+
+/**
+ * the registry task: checks which sensors are due every SENSOR_TICK_PERIOD ms.
+ */
+static void sensorTask(void *ignore)
+{
+	unsigned long wakeTime = millis();
+	while (true)
+	{
+		profileStart(profileId);
+		sampleSensors();
+		profileStop(profileId);
+		deadlineWait(deadlineId, &wakeTime, SENSOR_TICK_PERIOD);
+	}
+}
+
+/**
+ * sets up the sensors that need it, takes a first snapshot, and starts the registry task.
+ * reader reads the project's own SENSOR_TYPE_ROBOT... sensors (NULL if it has none). Call
+ * from initialize() after whatever those readings come from is started, and after
+ * stackMonitorInit(), profilerInit() and deadlineInit(): the registry task is watched, timed
+ * and kept to its deadline by all three.
+ */
+void sensorRegistryInit(SensorReader reader)
+{
+	unsigned long now = millis();
+	readRobotSensor = reader;
+	for (int id = 0; id < kSensorCount; id++)
+	{
+		if (kSensors[id].type == SENSOR_TYPE_ULTRASONIC)
+			ultrasonics[id] = ultrasonicInit(kSensors[id].port, kSensors[id].port2);
+		else if (kSensors[id].type == SENSOR_TYPE_DIGITAL)
+			pinMode(kSensors[id].port, INPUT);
+		nextDue[id] = now;
+	}
+	sampleSensors();
+
+	profileId = profileRegister("sensors");
+	deadlineId = deadlineRegister("sensors", DEADLINE_ACTION_SHED);
+	// below anything with a faster loop whose results it reads (an analog sampler, a gyro),
+	// above the tasks that use the snapshots.
+	taskCreateMonitored("sensors", sensorTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_DEFAULT + 1);
+}
+
+/**
+ * copies the latest snapshot of every sensor. Call once per cycle and use the copy for the
+ * whole cycle. Never waits for the registry task.
+ */
+void sensorSnapshotGet(SensorSnapshot *copy)
+{
+	SnapshotMailboxRead(&snapshots, copy);
+}
+
+/**
+ * prints every sensor's latest value and age.
+ */
+void sensorReport(PROS_FILE *stream)
+{
+	SensorSnapshot snapshot;
+	sensorSnapshotGet(&snapshot);
+	fprintf(stream, "snapshot %lu:\r\n", snapshot.cycle);
+	for (int id = 0; id < kSensorCount; id++)
+		fprintf(stream, "  %-20s %8d  (%lu ms old)\r\n", kSensors[id].name,
+		        snapshot.reading[id].value, snapshot.timestamp - snapshot.reading[id].timestamp);
+}
@@ -0,0 +1,228 @@
+/** @file StackMonitor.c
+ * @brief Watches how much of its stack each task really uses
+ *
+ * Every task gets TASK_DEFAULT_STACK_SIZE (512 words, 2 KB) whether it needs it or not, and
+ * the Cortex only has 64 KB of RAM. To find out what each one needs, tasks are started with
+ * taskCreateMonitored() instead of taskCreate(). Before the task's own code runs, it fills
+ * ("paints") the unused part of its stack with STACK_PAINT. Stack that has been used no
+ * longer holds the paint, so counting the painted words left at the bottom tells us the
+ * most the task has ever used - its "high-water mark". A low-priority task checks every
+ * task this way every STACK_SCAN_PERIOD ms and warns over the serial link when a task gets
+ * within STACK_WARN_WORDS of the end of its stack, so we find out in practice, not in a match.
+ *
+ * The kernel doesn't tell us where a task's stack is, but a task's stack starts (at the top)
+ * only a few words above the stack pointer in the first function it runs. So we paint from
+ * just below our own stack pointer down to STACK_RESERVED_WORDS short of where the bottom must
+ * be - never past it - which means the figures are within STACK_RESERVED_WORDS of the truth,
+ * on the safe side. (The addresses are worked out as plain numbers, and only turned into
+ * pointers for the writes: C doesn't allow pointer arithmetic that leaves the object it
+ * started from, and the compiler is free to assume it never happens.)
+ *
+ * operatorControl() and autonomous() are started by the kernel, so they call
+ * stackMonitorRegisterCurrent() to paint their own stacks.
+ */
+
+#include "kcore.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * one watched task.
+ */
+typedef struct {
+	const char *name;
+	TaskCode code;                      // what the task runs (taskCreateMonitored() only)
+	void *parameters;
+	TaskHandle handle;                  // NULL for the kernel's own tasks
+	bool autonomousMode;                // kernel tasks: was it the autonomous task?
+	unsigned int depth;                 // stack size, in words
+	unsigned int *bottom;               // lowest painted word
+	volatile unsigned int paintedWords; // 0 until the task has painted its stack
+	unsigned int minFree;               // fewest painted words ever left untouched
+	bool warned;                        // has the "running out" warning been printed?
+} StackRecord;
+
+static StackRecord records[STACK_MONITOR_MAX_TASKS];
+static volatile unsigned int numRecords = 0;
+
+/**
+ * paints the stack of the task that calls it, from STACK_PAINT_GUARD_WORDS below this
+ * function's own stack pointer down to the lowest word it can safely touch. Must not be
+ * inlined: its stack pointer has to be below everything the caller is using.
+ */
+static void __attribute__((noinline)) paintStack(StackRecord *record)
+{
+	uintptr_t sp;
+#ifdef __arm__
+	__asm__ volatile("mov %0, sp" : "=r"(sp));
+#else
+	// (on a PC - core/host - the frame address is near enough; the guard words cover the gap)
+	sp = (uintptr_t)__builtin_frame_address(0);
+#endif
+	const uintptr_t word = sizeof(unsigned int);
+	sp &= ~(word - 1);
+	uintptr_t top = sp - STACK_PAINT_GUARD_WORDS * word;
+	uintptr_t bottom = sp - (record->depth - STACK_RESERVED_WORDS) * word;
+
+	for (uintptr_t address = bottom; address < top; address += word)
+		*(unsigned int *)address = STACK_PAINT;
+
+	unsigned int painted = (top - bottom) / word;
+	record->bottom = (unsigned int *)bottom;
+	record->minFree = painted;
+	record->warned = false;
+	record->paintedWords = painted;
+}
+
+/**
+ * the first function every monitored task runs: paints its stack, then runs the real task.
+ */
+static void stackTrampoline(void *parameters)
+{
+	StackRecord *record = parameters;
+	paintStack(record);
+	record->code(record->parameters);
+}
+
+/**
+ * finds the record for the task called name, or claims a new one. Returns NULL if there are
+ * already STACK_MONITOR_MAX_TASKS tasks being watched.
+ */
+static StackRecord *findRecord(const char *name)
+{
+	for (unsigned int i = 0; i < numRecords; i++)
+		if (strcmp(records[i].name, name) == 0)
+			return &records[i];
+	if (numRecords >= STACK_MONITOR_MAX_TASKS)
+		return NULL;
+	StackRecord *record = &records[numRecords];
+	record->name = name;
+	record->paintedWords = 0;
+	numRecords++;
+	return record;
+}
+
+/**
+ * just like taskCreate(), but the task's stack use is watched (and reported under "name").
+ * If too many tasks are already watched, the task is still started, just not watched.
+ */
+TaskHandle taskCreateMonitored(const char *name, TaskCode taskCode,
+                               const unsigned int stackDepth, void *parameters,
+                               const unsigned int priority)
+{
+	StackRecord *record = findRecord(name);
+	if (record == NULL || stackDepth <= STACK_RESERVED_WORDS + STACK_PAINT_GUARD_WORDS)
+		return taskCreate(taskCode, stackDepth, parameters, priority);
+
+	record->code = taskCode;
+	record->parameters = parameters;
+	record->depth = stackDepth;
+	record->paintedWords = 0;
+	record->handle = taskCreate(stackTrampoline, stackDepth, record, priority);
+	return record->handle;
+}
+
+/**
+ * watches the stack of the task that calls this, which the kernel started with stackDepth
+ * words of stack. For operatorControl() and autonomous(); call it first thing. Calling it
+ * again when the task is restarted paints the new stack.
+ */
+void stackMonitorRegisterCurrent(const char *name, unsigned int stackDepth)
+{
+	StackRecord *record = findRecord(name);
+	if (record == NULL)
+		return;
+	record->handle = NULL;
+	record->autonomousMode = isAutonomous();
+	record->depth = stackDepth;
+	record->paintedWords = 0;
+	paintStack(record);
+}
+
+/**
+ * counts the painted words left at the bottom of a task's stack.
+ */
+static unsigned int countFree(const StackRecord *record)
+{
+	unsigned int untouched = 0;
+	while (untouched < record->paintedWords && record->bottom[untouched] == STACK_PAINT)
+		untouched++;
+	return untouched;
+}
+
+/**
+ * true if the task behind this record is running now, so its stack is really its own. (The
+ * kernel frees operatorControl()'s stack when the robot is disabled, for instance.)
+ */
+static bool isAlive(const StackRecord *record)
+{
+	if (record->paintedWords == 0)
+		return false;
+	if (record->handle != NULL)
+		return taskGetState(record->handle) != TASK_DEAD;
+	return isEnabled() && isAutonomous() == record->autonomousMode;
+}
+
+/**
+ * checks every watched task once, and warns about any that are close to overflowing.
+ */
+static void scanStacks()
+{
+	for (unsigned int i = 0; i < numRecords; i++)
+	{
+		StackRecord *record = &records[i];
+		if (!isAlive(record))
+			continue;
+		unsigned int untouched = countFree(record);
+		if (untouched < record->minFree)
+			record->minFree = untouched;
+		if (untouched < STACK_WARN_WORDS && !record->warned)
+		{
+			printf("stack warning: %s has only %u of %u words left\r\n", record->name,
+			       untouched, record->depth);
+			record->warned = true;
+		}
+	}
+}
+
+/**
+ * the stack monitor task: scans every STACK_SCAN_PERIOD ms.
+ */
+static void stackMonitorTask(void *ignore)
+{
+	while (true)
+	{
+		scanStacks();
+		delay(STACK_SCAN_PERIOD);
+	}
+}
+
+/**
+ * starts the task that checks every watched stack. Call once, from initialize().
+ */
+void stackMonitorInit()
+{
+	taskCreateMonitored("stacks", stackMonitorTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_LOWEST);
+}
+
+/**
+ * prints each watched task's stack size and the most it has used. "Used" counts the words
+ * this file can't check, so the real figure is up to STACK_RESERVED_WORDS lower.
+ */
+void stackReport(PROS_FILE *stream)
+{
+	fprintf(stream, "task        size  most used  left\r\n");
+	for (unsigned int i = 0; i < numRecords; i++)
+	{
+		const StackRecord *record = &records[i];
+		if (record->paintedWords == 0)
+		{
+			fprintf(stream, "%-10s %5u  (not started)\r\n", record->name, record->depth);
+			continue;
+		}
+		fprintf(stream, "%-10s %5u  %9u  %4u%s\r\n", record->name, record->depth,
+		        record->depth - record->minFree, record->minFree,
+		        record->minFree < STACK_WARN_WORDS ? "  LOW" : "");
+	}
+}
@@ -0,0 +1,142 @@
+/** @file Telemetry.c
+ * @brief Streams what the robot is doing out of UART 2, in compact binary frames
+ *
+ * printf() in the drive loop is slow, and blocks when the serial buffer fills. Instead, the
+ * drive loop asks telemetryBegin() for a frame once per cycle, copies the numbers we care
+ * about into it and hands it to telemetryCommit() - no formatting, no waiting. A low-priority
+ * task takes the frames off the queue, adds a CRC, COBS-encodes them and writes them to
+ * UART 2, where tools/telemetry.py can decode, record and plot them.
+ *
+ * What is in a frame is up to the project: it names its frame type with K_TELEMETRY(), and
+ * fills the frames in itself. This file only moves them, as bytes.
+ *
+ * The frames come from an ObjectPool, and the queue is a RingBuffer.h ring of pointers to
+ * them: the drive loop is the only task that takes frames from the pool and queues them, and
+ * the telemetry task is the only one that unqueues them and gives them back. The pool holds
+ * as many frames as the queue, so a queued frame always fits; if the telemetry task falls
+ * behind, the pool runs dry and new frames are dropped (and the next one that gets through
+ * says so).
+ */
+
+#include "kcore.h"
+#include <string.h>
+
+typedef unsigned char *FramePointer;
+RING_BUFFER_DECLARE(FrameQueue, FramePointer, TELEMETRY_QUEUE_SIZE)
+
+static ObjectPool framePool;
+static FrameQueue queue;
+
+// only the drive loop touches these.
+static unsigned short sequence = 0;
+static unsigned long lastSample = 0;
+static bool droppedSinceLast = false;
+
+// statistics for the "telemetry" report.
+static unsigned long framesDropped = 0;
+static unsigned long framesSent = 0;
+static unsigned long bytesSent = 0;
+
+/**
+ * a blank frame for the drive loop to fill in, or NULL if no frame is due: frames are sent
+ * at most every TELEMETRY_PERIOD ms, and none while the robot is degraded or the queue is
+ * full. stamp is filled in with the frame's sequence number and timing. Call once per cycle
+ * from the loop that drives the motors (and only that loop), and hand the frame to
+ * telemetryCommit(). Takes a few microseconds, and never waits.
+ */
+void *telemetryBegin(TelemetryStamp *stamp)
+{
+	// telemetry is optional; when the robot can't keep up, it is one of the first things to go.
+	if (micros() - lastSample < TELEMETRY_PERIOD * 1000UL)
+		return NULL;
+	if (deadlineDegraded())
+	{
+		droppedSinceLast = true;
+		return NULL;
+	}
+
+	unsigned char *frame = poolAlloc(&framePool);
+	if (frame == NULL)
+	{
+		framesDropped++;
+		droppedSinceLast = true;
+		return NULL;
+	}
+
+	unsigned long now = micros();
+	stamp->sequence = sequence++;
+	stamp->time_us = now;
+	stamp->cycle_us = now - lastSample;
+	stamp->dropped = droppedSinceLast;
+	lastSample = now;
+	droppedSinceLast = false;
+	return frame;
+}
+
+/**
+ * queues a frame from telemetryBegin(), once it is filled in, to be sent.
+ */
+void telemetryCommit(void *frame)
+{
+	FramePointer pointer = frame;
+	// can't fail: there are only as many frames as there is room in the queue.
+	FrameQueuePush(&queue, &pointer);
+}
+
+/**
+ * adds the CRC to one frame, encodes it and writes it out of UART 2.
+ */
+static void sendFrame(const unsigned char *frame)
+{
+	unsigned char raw[TELEMETRY_FRAME_MAX + 2];
+	unsigned char encoded[sizeof(raw) + sizeof(raw) / 254 + 2];
+
+	unsigned short crc = crc16(frame, kTelemetryFrameSize, CRC16_INITIAL);
+	memcpy(raw, frame, kTelemetryFrameSize);
+	raw[kTelemetryFrameSize] = crc & 0xFF;
+	raw[kTelemetryFrameSize + 1] = crc >> 8;
+
+	size_t length = cobsEncode(raw, kTelemetryFrameSize + 2, encoded);
+	encoded[length++] = 0; // end of frame
+	fwrite(encoded, 1, length, uart2);
+	framesSent++;
+	bytesSent += length;
+}
+
+/**
+ * the telemetry task: sends whatever frames are waiting, then sleeps for a bit.
+ */
+static void telemetryTask(void *ignore)
+{
+	FramePointer frame;
+	while (true)
+	{
+		while (FrameQueuePop(&queue, &frame))
+		{
+			sendFrame(frame);
+			poolFree(&framePool, frame);
+		}
+		delay(TELEMETRY_IDLE_WAIT);
+	}
+}
+
+/**
+ * sets up the frame pool and starts the telemetry task. Call once, from initialize(); UART 2
+ * must already be open at TELEMETRY_BAUD (see initializeIO()).
+ */
+void telemetryInit()
+{
+	poolInit(&framePool, "telemetry", kTelemetryFrameSize, TELEMETRY_QUEUE_SIZE);
+	// just above the kernel's idle task, so it only gets the time nobody else wants.
+	taskCreateMonitored("telemetry", telemetryTask, TASK_DEFAULT_STACK_SIZE, NULL,
+	                    TASK_PRIORITY_LOWEST + 1);
+}
+
+/**
+ * prints how many frames have been sent and dropped.
+ */
+void telemetryReport(PROS_FILE *stream)
+{
+	fprintf(stream, "%lu frames (%lu bytes) sent at %d baud, %lu dropped, %u queued\r\n",
+	        framesSent, bytesSent, TELEMETRY_BAUD, framesDropped, FrameQueueCount(&queue));
+}
@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+"""Where a robot project's flash and RAM go, worked out from the linker map.
+
+Every link writes bin/output.map (see MAPNAME in core/common.mk). This script reads it and
+adds up, for flash and for RAM:
+  - each symbol (function, table or variable), biggest first
+  - each file it came from: our own .o files, the core library's members, and the PROS and
+    gcc libraries' members
+
+The regions and their sizes come from the map's memory configuration (firmware/STM32F10x.ld:
+384 KB flash, 64 KB RAM). Initialized variables (.data) count against both: their starting
+values are kept in flash and copied to RAM at start-up. The arena counts against RAM; the
+kernel heap (task stacks) is whatever RAM is left over, so leave room for it. Static
+functions get their names from -ffunction-sections, but static variables are only listed as
+their file's "(.bss)" or "(.data)": the map only names global ones.
+
+  --save-baseline FILE   keep these figures, to compare a later build with
+  --baseline FILE        show what grew or shrank since the baseline was saved
+  --budget flash=300K    fail (exit status 1) if flash use is over 300 KB; likewise ram=.
+                         The Makefile checks FLASH_BUDGET and RAM_BUDGET this way after
+                         every link, with --quiet so only a problem is printed.
+
+usage: tools/memory_report.py <project directory> [--map FILE] [--top N] [options above]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+REGION = re.compile(r'^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+# ".text  0x08000130  0x1234" (an output section), maybe with "load address 0x...".
+OUTPUT_SECTION = re.compile(r'^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)'
+                            r'(?:\s+load address 0x([0-9a-fA-F]+))?)?\s*$')
+# " .text.foo  0x08000130  0x5c ./bin/auto.o" (an input section); the name may be on a line
+# of its own, with the rest on the next.
+INPUT_SECTION = re.compile(r'^ (\.\S+|COMMON|\*fill\*)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)'
+                           r'(?:\s+(.*))?)?\s*$')
+CONTINUATION = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.*))?$')
+SYMBOL = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$')
+# the section names -ffunction-sections and -fdata-sections give, e.g. ".text.autonomous"
+NAMED_SECTION = re.compile(r'^\.(?:text|rodata|data|bss)\.(.+)$')
+STRINGS = re.compile(r'^\.rodata\.str')
+# sections that only take room where they run, never in flash: ld gives .bss and the arena a
+# load address too, but there is nothing to load.
+ZERO_FILL = re.compile(r'^(\.bss|COMMON|\.arena|\.noinit)')
+
+SIZE = re.compile(r'^(\d+)([KM]?)$', re.I)
+
+
+class Piece:
+    """one stretch of an output section that belongs to one symbol of one file."""
+
+    def __init__(self, symbol, file, size, regions):
+        self.symbol = symbol
+        self.file = file
+        self.size = size
+        self.regions = regions
+
+
+def file_name(path):
+    """a short name for an input file: "auto.o", or "libkcore.a(Arena.o)"."""
+    path = path.strip()
+    archive = re.match(r'^(.*?)\((.*)\)$', path)
+    if archive:
+        return "%s(%s)" % (os.path.basename(archive.group(1)), archive.group(2))
+    return os.path.basename(path)
+
+
+def read_regions(lines):
+    """{"flash": (origin, length), "ram": (...)} from the map's memory configuration."""
+    regions = {}
+    inside = False
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            inside = True
+        elif line.startswith("Linker script and memory map"):
+            break
+        elif inside:
+            region = REGION.match(line)
+            if region and region.group(1) != "Name":
+                regions[region.group(1).lower()] = (int(region.group(2), 16),
+                                                    int(region.group(3), 16))
+    return regions
+
+
+def regions_of(address, load_address, size, regions):
+    """which regions a section at address (loaded from load_address) takes up room in."""
+    inside = set()
+    for name, (origin, length) in regions.items():
+        for where in (address, load_address):
+            if where is not None and size > 0 and origin <= where < origin + length:
+                inside.add(name)
+    return inside
+
+
+def read_map(path):
+    """(regions, list of Pieces) from a GNU ld map file."""
+    with open(path, errors="replace") as f:
+        lines = f.read().splitlines()
+    regions = read_regions(lines)
+    pieces = []
+    output_regions = set()
+    output_offset = None  # load address - address, for sections loaded somewhere else
+    section = None  # (name, address, size, file) of the input section being read
+    symbols = []  # (address, name) seen in it so far
+
+    def finish():
+        # split the input section between its symbols (the map only lists global ones; the
+        # rest goes to a name taken from the section, or to the section itself).
+        if section is None or section[2] == 0 or not output_regions:
+            return
+        name, address, size, path = section
+        named = NAMED_SECTION.match(name)
+        first = named.group(1) if named else "(%s)" % name
+        if STRINGS.match(name):
+            first = "(string constants)"
+        elif name == "*fill*":
+            first = "(padding)"
+        marks = [(address, first)] + sorted(s for s in symbols if address <= s[0] < address + size)
+        for i, (start, symbol) in enumerate(marks):
+            end = marks[i + 1][0] if i + 1 < len(marks) else address + size
+            if end > start:
+                regions_here = set(output_regions)
+                if output_offset and not ZERO_FILL.match(name):
+                    regions_here |= regions_of(start + output_offset, None, end - start, regions)
+                pieces.append(Piece(symbol, file_name(path) if path else "(linker)",
+                                    end - start, regions_here))
+
+    started = False
+    pending = None
+    for line in lines:
+        if not started:
+            started = line.startswith("Linker script and memory map")
+            continue
+        if pending is not None:
+            rest = CONTINUATION.match(line)
+            if rest:
+                finish()
+                section = (pending, int(rest.group(1), 16), int(rest.group(2), 16),
+                           rest.group(3) or "")
+                symbols = []
+            pending = None
+            continue
+
+        output = OUTPUT_SECTION.match(line)
+        if output:
+            finish()
+            section = None
+            if output.group(2) is None:
+                # the address is on the next line; the first input section tells us enough.
+                output_regions = set()
+                output_offset = None
+                continue
+            address, size = int(output.group(2), 16), int(output.group(3), 16)
+            load = int(output.group(4), 16) if output.group(4) else None
+            output_regions = regions_of(address, None, size, regions)
+            output_offset = (load - address) if load is not None else None
+            continue
+
+        found = INPUT_SECTION.match(line)
+        if found:
+            if found.group(2) is None:
+                pending = found.group(1)
+                continue
+            finish()
+            section = (found.group(1), int(found.group(2), 16), int(found.group(3), 16),
+                       found.group(4) or "")
+            symbols = []
+            if not output_regions:
+                # an output section whose address came on its own line: find it from here.
+                output_regions = regions_of(section[1], None, section[2], regions)
+            continue
+
+        symbol = SYMBOL.match(line)
+        if symbol and section is not None:
+            symbols.append((int(symbol.group(1), 16), symbol.group(2)))
+    finish()
+    return regions, pieces
+
+
+def totals(pieces):
+    """{region: {"total": n, "symbols": {name: n}, "files": {name: n}}}."""
+    result = {}
+    for piece in pieces:
+        for region in piece.regions:
+            entry = result.setdefault(region, {"total": 0, "symbols": {}, "files": {}})
+            entry["total"] += piece.size
+            key = "%s [%s]" % (piece.symbol, piece.file)
+            entry["symbols"][key] = entry["symbols"].get(key, 0) + piece.size
+            entry["files"][piece.file] = entry["files"].get(piece.file, 0) + piece.size
+    return result
+
+
+def parse_size(text):
+    size = SIZE.match(text.strip())
+    if not size:
+        raise ValueError("not a size: " + text)
+    return int(size.group(1)) * {"": 1, "K": 1024, "M": 1024 * 1024}[size.group(2).upper()]
+
+
+def print_table(title, sizes, baseline, top):
+    """the biggest entries of sizes (and, with a baseline, the biggest changes)."""
+    print("  %s:" % title)
+    for name, size in sorted(sizes.items(), key=lambda item: (-item[1], item[0]))[:top]:
+        print("    %8d  %s" % (size, name))
+    if baseline is None:
+        return
+    changes = [(size - baseline.get(name, 0), name) for name, size in sizes.items()]
+    changes += [(-size, name) for name, size in baseline.items() if name not in sizes]
+    changes = [change for change in changes if change[0] != 0]
+    if changes:
+        print("  %s that changed since the baseline:" % title)
+        for change, name in sorted(changes, key=lambda item: (-abs(item[0]), item[1]))[:top]:
+            was = baseline.get(name)
+            print("    %+8d  %s%s" % (change, name, "" if was is not None else " (new)"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("project", nargs="?", default=".",
+                        help="robot project directory, e.g. 'Mecanum 2017'")
+    parser.add_argument("--map", help="default: <project>/bin/output.map")
+    parser.add_argument("--top", type=int, default=15, help="how many rows in each table")
+    parser.add_argument("--baseline", metavar="FILE")
+    parser.add_argument("--save-baseline", metavar="FILE")
+    parser.add_argument("--budget", action="append", default=[], metavar="REGION=SIZE")
+    parser.add_argument("--quiet", action="store_true", help="only print budget problems")
+    args = parser.parse_args()
+
+    path = args.map or os.path.join(args.project, "bin", "output.map")
+    if not os.path.exists(path):
+        sys.exit("no linker map at %s - build first" % path)
+    regions, pieces = read_map(path)
+    if not regions:
+        sys.exit("%s has no memory configuration - is it a GNU ld map?" % path)
+    used = totals(pieces)
+
+    baseline = None
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    if not args.quiet:
+        for region in sorted(regions):
+            origin, length = regions[region]
+            entry = used.get(region, {"total": 0, "symbols": {}, "files": {}})
+            line = "%s: %d of %d bytes (%.1f%%)" % (region, entry["total"], length,
+                                                   100.0 * entry["total"] / length)
+            if baseline is not None and region in baseline:
+                line += ", %+d since the baseline" % (entry["total"] - baseline[region]["total"])
+            print(line)
+            was = baseline.get(region) if baseline is not None else None
+            print_table("files", entry["files"], was and was["files"], args.top)
+            print_table("symbols", entry["symbols"], was and was["symbols"], args.top)
+            print()
+
+    if args.save_baseline:
+        with open(args.save_baseline, "w") as f:
+            json.dump(used, f, indent=1, sort_keys=True)
+
+    over = False
+    for budget in args.budget:
+        region, _, limit = budget.partition("=")
+        region = region.lower()
+        if region not in regions:
+            sys.exit("no region %s in the map (have: %s)" % (region, ", ".join(sorted(regions))))
+        limit = parse_size(limit)
+        total = used.get(region, {"total": 0})["total"]
+        if total > limit:
+            over = True
+            print("%s: %d bytes used, over the budget of %d by %d" % (region, total, limit,
+                                                                     total - limit),
+                  file=sys.stderr)
+            biggest = sorted(used[region]["files"].items(), key=lambda item: -item[1])[:5]
+            print("  biggest: " + ", ".join("%s %d" % item for item in biggest), file=sys.stderr)
+    return 1 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Checks on the simulator that the wheels and the gyro agree on how fast the robot turns.
+
+Runs the Mecanum 2017 robot on a PC (build it first with "make host" in that folder), has
+the driver spin it on the spot at a steady speed, and asks the console for "odometry" every
+half second. While the spin is steady, the turn rate the wheels give (Odometry.c) must
+average out within TOLERANCE of the gyro's; if ODOMETRY_TICKS_PER_TURN and the way the
+wheels are added up ever stop meaning the same thing, it won't. (Single readings wander by
+several percent: the simulator times encoder edges to the nearest millisecond, and a
+reading only spans a few edges.) Prints each reading, and exits with 1 if the rates don't
+match (or the robot never spun).
+
+usage: tools/spin_check.py [--robot "Mecanum 2017/bin/host/robot"] [--power 60]
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+DEFAULT_ROBOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                             "Mecanum 2017", "bin", "host", "robot")
+
+# how far apart the wheels and the gyro may be on average, as a share of the gyro's rate
+TOLERANCE = 0.05
+
+# a reading counts as steady once the gyro is within this share of the fastest it saw
+STEADY = 0.9
+
+# seconds of driver control: still, then spinning, then still again
+SPIN_START = 1
+SPIN_STOP = 6
+DRIVER_SECONDS = 7
+
+REPORT = re.compile(r"turning (-?\d+) mdeg/s \(wheels (-?\d+)\)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--robot", default=DEFAULT_ROBOT, help="the host build of the robot")
+    parser.add_argument("--power", type=int, default=60, help="joystick twist, 1-127")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as folder:
+        script = os.path.join(folder, "spin")
+        with open(script, "w") as f:
+            f.write("0 0 0 0 0\n%d 0 0 0 %d\n%d 0 0 0 0\n"
+                    % (SPIN_START * 1000, args.power, SPIN_STOP * 1000))
+        robot = subprocess.Popen([args.robot, "-d", str(DRIVER_SECONDS), "-j", script,
+                                  "-f", os.path.join(folder, "flash")],
+                                 stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                 stderr=subprocess.DEVNULL, universal_newlines=True)
+
+        def ask():
+            try:
+                while robot.poll() is None:
+                    robot.stdin.write("odometry\n")
+                    robot.stdin.flush()
+                    time.sleep(0.5)
+            except BrokenPipeError:
+                pass
+
+        asker = threading.Thread(target=ask, daemon=True)
+        asker.start()
+        readings = [(int(m.group(1)), int(m.group(2)))
+                    for m in map(REPORT.search, robot.stdout) if m]
+        robot.wait()
+
+    fastest = max((abs(gyro) for gyro, _ in readings), default=0)
+    steady = [(gyro, wheels) for gyro, wheels in readings
+              if fastest > 0 and abs(gyro) >= STEADY * fastest]
+    for gyro, wheels in readings:
+        print("gyro %7d mdeg/s  wheels %7d mdeg/s%s"
+              % (gyro, wheels, "  steady" if (gyro, wheels) in steady else ""))
+    if not steady:
+        print("the robot never spun", file=sys.stderr)
+        sys.exit(1)
+    gyro = sum(g for g, _ in steady) / len(steady)
+    wheels = sum(w for _, w in steady) / len(steady)
+    ok = abs(wheels - gyro) <= TOLERANCE * abs(gyro)
+    print("steady spin (%d readings): gyro %.0f mdeg/s, wheels %.0f mdeg/s - %s"
+          % (len(steady), gyro, wheels, "ok" if ok else "OFF by more than %d%%"
+             % (TOLERANCE * 100)), file=sys.stderr)
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
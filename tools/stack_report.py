@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Worst-case stack use of each task in a robot project, worked out at build time.
+
+Building with -fstack-usage (core/common.mk) makes gcc write each function's own stack frame
+size to bin/*.su, and to core/bin/*.su for the core library. This script disassembles
+bin/output.elf to find which function calls which, then adds up the frames along the deepest
+call chain from each task's entry point and compares that to the stack the task was given.
+
+The tasks are found by looking for taskCreateMonitored("name", function, depth, ...) in
+src/*.c and core/src/*.c (if the project links that part of the core), plus operatorControl()
+and autonomous(), which the kernel starts with TASK_DEFAULT_STACK_SIZE words.
+
+Some things can't be seen this way, and are marked in the report:
+  +?  the chain calls a function with no .su entry (the PROS library, libgcc)
+  *   the chain calls through a function pointer
+  R   the chain is recursive
+So treat the figures as a floor, and check them against the "stacks" console command.
+
+usage: tools/stack_report.py <project directory> [--objdump arm-none-eabi-objdump]
+"""
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+
+# an interrupt stacks 8 registers onto whatever task it interrupts.
+INTERRUPT_FRAME_BYTES = 32
+
+# words of stack the kernel starts its own tasks with (API.h)
+KERNEL_DEFINES = {"TASK_DEFAULT_STACK_SIZE": 512, "TASK_MINIMAL_STACK_SIZE": 64}
+
+CREATE_CALL = re.compile(r'taskCreateMonitored\(\s*"([^"]+)"\s*,\s*(\w+)\s*,\s*([^,]+),')
+DEFINE = re.compile(r'^\s*#define\s+(\w+)\s+(\d+)\b', re.M)
+FUNCTION_START = re.compile(r'^[0-9a-f]+ <([^>]+)>:$')
+CALL = re.compile(r'\s(?:bl|blx|call|callq)\s+[0-9a-f]+\s+<([^>+]+)(?:\+0x[0-9a-f]+)?>')
+INDIRECT_CALL = re.compile(r'\s(?:blx\s+r\d+|callq?\s+\*)')
+
+
+def read_frame_sizes(bindir):
+    """function name -> bytes of stack its own frame uses, from every .su file."""
+    sizes = {}
+    for path in glob.glob(os.path.join(bindir, "*.su")):
+        with open(path) as su:
+            for line in su:
+                # e.g. "src/Odometry.c:61:13:updateHeading	48	static"
+                location, size, _kind = line.rstrip("\n").split("\t")
+                sizes[location.rsplit(":", 1)[1]] = int(size)
+    return sizes
+
+
+def read_call_graph(elf, objdump):
+    """function name -> (set of functions it calls, whether it calls through a pointer)."""
+    listing = subprocess.run([objdump, "-d", elf], check=True, capture_output=True,
+                             text=True).stdout
+    calls = {}
+    current = None
+    for line in listing.splitlines():
+        start = FUNCTION_START.match(line)
+        if start:
+            current = start.group(1)
+            calls[current] = (set(), False)
+            continue
+        if current is None:
+            continue
+        callees, indirect = calls[current]
+        call = CALL.search(line)
+        if call:
+            callees.add(call.group(1))
+        elif INDIRECT_CALL.search(line):
+            calls[current] = (callees, True)
+    return calls
+
+
+def core_dir(project):
+    """the shared core library every project links (core/, next to the projects)."""
+    return os.path.join(project, "..", "core")
+
+
+def read_tasks(project):
+    """(task name, entry function, stack words) for every task the project starts."""
+    defines = dict(KERNEL_DEFINES)
+    for header in glob.glob(os.path.join(project, "include", "*.h")) + \
+            glob.glob(os.path.join(core_dir(project), "include", "*.h")):
+        with open(header, errors="replace") as f:
+            defines.update((name, int(value)) for name, value in DEFINE.findall(f.read()))
+
+    tasks = [("opcontrol", "operatorControl", defines["TASK_DEFAULT_STACK_SIZE"]),
+             ("auto", "autonomous", defines["TASK_DEFAULT_STACK_SIZE"])]
+    sources = sorted(glob.glob(os.path.join(project, "src", "*.c"))) + \
+        sorted(glob.glob(os.path.join(core_dir(project), "src", "*.c")))
+    for source in sources:
+        with open(source, errors="replace") as f:
+            for name, entry, depth in CREATE_CALL.findall(f.read()):
+                depth = depth.strip()
+                words = int(depth) if depth.isdigit() else defines.get(depth)
+                tasks.append((name, entry, words))
+    return tasks
+
+
+class StackWalker:
+    """works out the deepest call chain below each function, remembering the answers."""
+
+    def __init__(self, sizes, calls):
+        self.sizes = sizes
+        self.calls = calls
+        self.memo = {}
+        self.active = set()
+
+    def deepest(self, function):
+        """(bytes, chain of function names, flags) for the deepest chain from function."""
+        if function in self.memo:
+            return self.memo[function]
+        if function in self.active:
+            return 0, [function], {"R"}
+        self.active.add(function)
+
+        own = self.sizes.get(function)
+        flags = set() if own is not None else {"+?"}
+        callees, indirect = self.calls.get(function, (set(), False))
+        if indirect:
+            flags.add("*")
+        best = (0, [], set())
+        for callee in sorted(callees):
+            below = self.deepest(callee)
+            flags |= below[2]
+            if below[0] > best[0]:
+                best = below
+
+        self.active.discard(function)
+        result = ((own or 0) + best[0], [function] + best[1], flags)
+        self.memo[function] = result
+        return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("project", help="robot project directory, e.g. 'Mecanum 2017'")
+    parser.add_argument("--objdump", default="arm-none-eabi-objdump")
+    parser.add_argument("--elf", help="default: <project>/bin/output.elf")
+    args = parser.parse_args()
+
+    bindir = os.path.join(args.project, "bin")
+    sizes = read_frame_sizes(bindir)
+    sizes.update(read_frame_sizes(os.path.join(core_dir(args.project), "bin")))
+    if not sizes:
+        sys.exit("no .su files in %s - build with -fstack-usage first" % bindir)
+    calls = read_call_graph(args.elf or os.path.join(bindir, "output.elf"), args.objdump)
+    walker = StackWalker(sizes, calls)
+
+    over = False
+    print("%-10s %-20s %6s %6s %6s  %s" % ("task", "entry", "needs", "has", "spare",
+                                           "deepest chain"))
+    for name, entry, words in read_tasks(args.project):
+        if entry not in calls:
+            continue  # a core task this robot doesn't use
+        needed, chain, flags = walker.deepest(entry)
+        needed += INTERRUPT_FRAME_BYTES
+        has = words * 4 if words else 0
+        spare = has - needed
+        over = over or spare < 0
+        print("%-10s %-20s %6d %6d %6d  %s %s" % (name, entry, needed, has, spare,
+                                                  " > ".join(chain), "".join(sorted(flags))))
+    print("(bytes; needs includes %d for an interrupt's stacked registers)"
+          % INTERRUPT_FRAME_BYTES)
+    return 1 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+"""Decode, record and plot the robot's binary telemetry (Telemetry.c).
+
+The frame layout is read from TELEMETRY_FIELDS in the robot's TelemetryFrame.h, so this tool
+always agrees with the code that sent the frames. Each frame on the wire is the packed
+fields, then a CRC-16/CCITT of them, COBS-encoded and ended by a zero byte.
+
+Reading from:
+  - a serial port (needs pyserial):       tools/telemetry.py /dev/ttyUSB0
+  - a saved raw stream, or a pty:         tools/telemetry.py capture.bin
+
+What to do with the frames (any combination):
+  --print            print each frame as a line of text
+  --record DIR       save every field as its own column file, DIR/<field>.bin, plus
+                     DIR/schema.json saying what type each one is. load(DIR) in this file
+                     reads them back as arrays, one per field.
+  --plot a,b,...     plot those fields live (needs matplotlib); every frame is still decoded
+                     and recorded - only the screen is redrawn less often.
+  --raw FILE         also save the undecoded stream, to play back later
+
+Bad frames (wrong length, CRC or version) are counted and skipped; gaps in the sequence
+numbers are counted as lost frames.
+"""
+
+import argparse
+import array
+import json
+import os
+import re
+import struct
+import sys
+import threading
+import time
+import traceback
+from collections import deque
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                              "Mecanum 2017", "include", "TelemetryFrame.h")
+
+# struct codes for the types TelemetryFrame.h may use.
+TYPE_CODES = {"int8_t": "b", "uint8_t": "B", "int16_t": "h", "uint16_t": "H",
+              "int32_t": "i", "uint32_t": "I"}
+
+FIELD = re.compile(r'X\(\s*(\w+)\s*,\s*(\w+)\s*,\s*"([^"]*)"\s*\)')
+VERSION = re.compile(r'#define\s+TELEMETRY_VERSION\s+(\d+)')
+
+
+class Schema:
+    """the frame layout from TelemetryFrame.h."""
+
+    def __init__(self, header):
+        with open(header) as f:
+            text = f.read()
+        self.version = int(VERSION.search(text).group(1))
+        self.fields = [(name, kind, description)
+                       for kind, name, description in FIELD.findall(text)]
+        if not self.fields:
+            raise ValueError("no TELEMETRY_FIELDS found in " + header)
+        for name, kind, _ in self.fields:
+            if kind not in TYPE_CODES:
+                raise ValueError("%s: don't know the size of %s" % (name, kind))
+        self.names = [name for name, _, _ in self.fields]
+        self.format = "<" + "".join(TYPE_CODES[kind] for _, kind, _ in self.fields)
+        self.size = struct.calcsize(self.format)
+
+    def to_json(self):
+        return {"version": self.version,
+                "fields": [{"name": n, "type": k, "code": TYPE_CODES[k], "description": d}
+                           for n, k, d in self.fields]}
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT, as crc16() in core/src/Checksum.c."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """undoes cobsEncode() in core/src/Cobs.c; None if the data can't be COBS."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class Decoder:
+    """turns a stream of bytes into frames (dicts of field values)."""
+
+    def __init__(self, schema):
+        self.schema = schema
+        self.pending = bytearray()
+        self.frames = 0
+        self.bad = 0
+        self.lost = 0
+        self.last_sequence = None
+
+    def feed(self, data):
+        """decodes every complete frame in data (plus whatever was left over last time)."""
+        self.pending += data
+        frames = []
+        while True:
+            end = self.pending.find(0)
+            if end < 0:
+                return frames
+            packet = bytes(self.pending[:end])
+            del self.pending[:end + 1]
+            if packet:
+                frame = self.decode(packet)
+                if frame is not None:
+                    frames.append(frame)
+
+    def decode(self, packet):
+        raw = cobs_decode(packet)
+        if raw is None or len(raw) != self.schema.size + 2:
+            self.bad += 1
+            return None
+        body, (crc,) = raw[:-2], struct.unpack("<H", raw[-2:])
+        if crc16(body) != crc:
+            self.bad += 1
+            return None
+        frame = dict(zip(self.schema.names, struct.unpack(self.schema.format, body)))
+        if frame.get("version", self.schema.version) != self.schema.version:
+            self.bad += 1
+            return None
+
+        sequence = frame.get("sequence")
+        if sequence is not None and self.last_sequence is not None:
+            self.lost += (sequence - self.last_sequence - 1) & 0xFFFF
+        self.last_sequence = sequence
+        self.frames += 1
+        return frame
+
+
+class Recorder:
+    """appends each field to its own column file, a chunk at a time."""
+
+    CHUNK = 256
+
+    def __init__(self, directory, schema):
+        os.makedirs(directory, exist_ok=True)
+        with open(os.path.join(directory, "schema.json"), "w") as f:
+            json.dump(schema.to_json(), f, indent=1)
+        self.schema = schema
+        self.files = {name: open(os.path.join(directory, name + ".bin"), "ab")
+                      for name in schema.names}
+        self.columns = {name: [] for name in schema.names}
+
+    def add(self, frame):
+        for name in self.schema.names:
+            self.columns[name].append(frame[name])
+        if len(self.columns[self.schema.names[0]]) >= self.CHUNK:
+            self.flush()
+
+    def flush(self):
+        for name, kind, _ in self.schema.fields:
+            values = self.columns[name]
+            if values:
+                self.files[name].write(struct.pack("<%d%s" % (len(values), TYPE_CODES[kind]),
+                                                   *values))
+                self.files[name].flush()
+            self.columns[name] = []
+
+    def close(self):
+        self.flush()
+        for f in self.files.values():
+            f.close()
+
+
+def load(directory):
+    """reads a recording back: {field name: numpy array} (or array.array, without numpy)."""
+    with open(os.path.join(directory, "schema.json")) as f:
+        schema = json.load(f)
+    columns = {}
+    for field in schema["fields"]:
+        path = os.path.join(directory, field["name"] + ".bin")
+        try:
+            import numpy
+            columns[field["name"]] = numpy.fromfile(path, dtype="<" + field["code"])
+        except ImportError:
+            with open(path, "rb") as f:
+                data = f.read()
+            count = len(data) // struct.calcsize("<" + field["code"])
+            columns[field["name"]] = array.array(
+                field["code"], struct.unpack("<%d%s" % (count, field["code"]), data))
+    return columns
+
+
+def open_source(path, baud):
+    """a function that returns the next chunk of bytes (b"" at the end of a file)."""
+    if os.path.isfile(path):
+        f = open(path, "rb")
+        return lambda: f.read(4096)
+    try:
+        import serial
+    except ImportError:
+        f = open(path, "rb", buffering=0)   # a pty, or a port already set up with stty
+        return lambda: f.read(4096)
+    port = serial.Serial(path, baud, timeout=0.05)
+    return lambda: port.read(4096) or None   # None: nothing yet, but not finished
+
+
+class LivePlot:
+    """keeps the last few seconds of some fields, and redraws them now and then."""
+
+    def __init__(self, names, seconds):
+        import matplotlib.pyplot as plt
+        self.plt = plt
+        self.names = names
+        self.seconds = seconds
+        self.lock = threading.Lock()
+        self.times = deque()
+        self.values = {name: deque() for name in names}
+        self.figure, axes = plt.subplots(len(names), 1, sharex=True, squeeze=False)
+        self.lines = {}
+        for axis, name in zip(axes[:, 0], names):
+            axis.set_ylabel(name)
+            self.lines[name], = axis.plot([], [])
+        axes[-1, 0].set_xlabel("seconds")
+
+    def add(self, frame):
+        with self.lock:
+            now = frame["time_us"] / 1e6
+            self.times.append(now)
+            for name in self.names:
+                self.values[name].append(frame[name])
+            while self.times and self.times[0] < now - self.seconds:
+                self.times.popleft()
+                for name in self.names:
+                    self.values[name].popleft()
+
+    def redraw(self):
+        with self.lock:
+            times = list(self.times)
+            values = {name: list(self.values[name]) for name in self.names}
+        for name in self.names:
+            line = self.lines[name]
+            line.set_data(times, values[name])
+            line.axes.relim()
+            line.axes.autoscale_view()
+        self.figure.canvas.draw_idle()
+        self.plt.pause(0.05)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", help="serial port, pty or saved raw stream")
+    parser.add_argument("--header", default=DEFAULT_HEADER, help="TelemetryFrame.h to use")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--print", action="store_true", dest="print_frames")
+    parser.add_argument("--record", metavar="DIR")
+    parser.add_argument("--raw", metavar="FILE")
+    parser.add_argument("--plot", metavar="FIELDS")
+    parser.add_argument("--seconds", type=float, default=10, help="how much to plot")
+    args = parser.parse_args()
+
+    schema = Schema(args.header)
+    decoder = Decoder(schema)
+    recorder = Recorder(args.record, schema) if args.record else None
+    raw = open(args.raw, "ab") if args.raw else None
+    plot = None
+    if args.plot:
+        names = args.plot.split(",")
+        unknown = [n for n in names if n not in schema.names]
+        if unknown:
+            sys.exit("no such field(s): %s (have: %s)" % (", ".join(unknown),
+                                                           ", ".join(schema.names)))
+        plot = LivePlot(names, args.seconds)
+
+    read = open_source(args.source, args.baud)
+    done = threading.Event()
+    failed = []  # what stopped the reader, if it didn't just run out of input
+
+    def reader():
+        # every byte is decoded (and recorded) here, however slowly the plot redraws.
+        try:
+            while not done.is_set():
+                data = read()
+                if data == b"":
+                    break
+                if not data:
+                    continue
+                if raw:
+                    raw.write(data)
+                for frame in decoder.feed(data):
+                    if recorder:
+                        recorder.add(frame)
+                    if plot:
+                        plot.add(frame)
+                    if args.print_frames:
+                        print(" ".join("%s=%d" % item for item in frame.items()))
+        except BaseException as error:
+            failed.append(error)
+        finally:
+            # (always, or main() would wait for ever)
+            done.set()
+
+    thread = threading.Thread(target=reader, daemon=True)
+    thread.start()
+    try:
+        while not done.is_set():
+            if plot:
+                plot.redraw()
+            else:
+                time.sleep(0.1)
+    except KeyboardInterrupt:
+        done.set()
+    thread.join(1)
+
+    if recorder:
+        recorder.close()
+    if raw:
+        raw.close()
+    print("%d frames, %d bad, %d lost" % (decoder.frames, decoder.bad, decoder.lost),
+          file=sys.stderr)
+
+    if failed:
+        error = failed[0]
+        if isinstance(error, BrokenPipeError):
+            # whatever was reading --print has stopped ("| head"); that's fine, but anything
+            # still buffered for it can't be written either.
+            os.dup2(os.open(os.devnull, os.O_WRONLY), sys.stdout.fileno())
+            return
+        print("stopped reading:", file=sys.stderr)
+        traceback.print_exception(type(error), error, error.__traceback__)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()